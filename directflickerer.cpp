@@ -0,0 +1,113 @@
+//This file is part of The Garden Path
+
+//The Garden Path is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//The Garden Path is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with The Garden Path.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "directflickerer.h"
+#include "framegovernor.h"
+
+/**
+Constructor:
+  Creates a timer to swap frames as often as user requested
+*/
+DirectFlickerer::DirectFlickerer(const QGLFormat& fmt, int timerInterval)
+    : QGLWidget(fmt)
+{
+    // Nothing but GL ever touches this window
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setAttribute(Qt::WA_NoSystemBackground);
+    setAutoFillBackground(false);
+
+    if( timerInterval == 0 )
+        m_timer = 0;
+    else
+    {
+        m_timer = new QTimer( this );
+        connect( m_timer, SIGNAL(timeout()), this, SLOT(timeOutSlot()) );
+        m_timer->start( timerInterval );
+    }
+}
+
+/**
+Initialize GL:
+  Only flat colored quads are drawn
+*/
+void DirectFlickerer::initializeGL()
+{
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_BLEND);
+    glDisable(GL_DITHER);
+    glShadeModel(GL_SMOOTH);
+}
+
+/**
+Resize GL:
+  Pixel-space projection with the origin at the top left
+*/
+void DirectFlickerer::resizeGL(int width, int height)
+{
+    glViewport(0, 0, width, height);
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    glOrtho(0, width, height, 0, -1, 1);
+
+    painter.setSize(QSize(width, height));
+}
+
+/**
+Paint GL:
+  Draws the current gradient without advancing the flicker
+*/
+void DirectFlickerer::paintGL()
+{
+    painter.paint();
+}
+
+/**
+Timeout Slot:
+  Show the other gradient; updateGL() draws and swaps right away
+  instead of queueing a paint event that could be merged
+*/
+void DirectFlickerer::timeOutSlot()
+{
+    painter.advance();
+    updateGL();
+
+    if(governor) governor->frameDone();
+}
+
+/**
+Set timer:
+  Updates the timer speed
+*/
+void DirectFlickerer::setTimer(int hz)
+{
+    m_timer->setInterval(timerInterval(hz));
+}
+
+/**
+Set Box Nums:
+  Updates the number of boxes displayed
+*/
+void DirectFlickerer::setBoxNum(int num)
+{
+    painter.setBoxNum(num);
+}
+
+/**
+Set various colors:
+  Updates the color in each gradient
+*/
+void DirectFlickerer::setColors(int colorVals[]) {
+    painter.setColors(colorVals);
+}
@@ -0,0 +1,53 @@
+//This file is part of The Garden Path
+
+//The Garden Path is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//The Garden Path is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with The Garden Path.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef DIRECTFLICKERER_H
+#define DIRECTFLICKERER_H
+
+#include <QtOpenGL/QGLWidget>
+#include <QTimer>
+
+#include "flickerdisplay.h"
+#include "flickerpainter.h"
+
+// Renders straight into its own GL context: no scene, no view,
+// no QPainter. Each tick draws and swaps synchronously.
+class DirectFlickerer : public QGLWidget, public FlickerDisplay
+{
+    Q_OBJECT
+
+public:
+    explicit DirectFlickerer(const QGLFormat& fmt, int timerInterval);
+    void setTimer(int);
+    void setBoxNum(int);
+    void setColors(int vals[12]);
+
+protected:
+    void initializeGL();
+    void resizeGL(int, int);
+    void paintGL();
+
+private:
+    //used to swap frames at a given interval
+    QTimer *m_timer;
+
+    FlickerPainter painter;
+
+public slots:
+  //slot used to draw and swap the next frame when invoked by m_timer
+  void timeOutSlot();
+};
+
+#endif // DIRECTFLICKERER_H
@@ -0,0 +1,48 @@
+//This file is part of The Garden Path
+
+//The Garden Path is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//The Garden Path is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with The Garden Path.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef FLICKERDISPLAY_H
+#define FLICKERDISPLAY_H
+
+#define MAX_SPEED_VAL -1
+
+class FrameGovernor;
+
+// What the options window drives, whichever way the flicker is rendered
+class FlickerDisplay
+{
+public:
+    FlickerDisplay() : governor(0) {}
+    virtual ~FlickerDisplay() {}
+    virtual void setTimer(int) = 0;
+    virtual void setBoxNum(int) = 0;
+    virtual void setColors(int vals[12]) = 0;
+
+    // Timer interval in ms for a rate in Hz
+    static int timerInterval(int hz)
+    {
+        if(hz==MAX_SPEED_VAL) return 0;
+        else if(hz <= 0) return 100000;
+        else return 1000.0 / hz;
+    }
+
+    // Told about every frame put on screen; may be NULL
+    void setGovernor(FrameGovernor* g) { governor = g; }
+
+protected:
+    FrameGovernor* governor;
+};
+
+#endif // FLICKERDISPLAY_H
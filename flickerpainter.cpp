@@ -0,0 +1,149 @@
+//This file is part of The Garden Path
+
+//The Garden Path is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//The Garden Path is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with The Garden Path.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <cmath>
+#include <qgl.h>
+
+#include "flickerpainter.h"
+
+/**
+Constructor:
+  Starts with a single black box
+*/
+FlickerPainter::FlickerPainter()
+{
+    for(int i=0; i<3; i++)
+        g1c1_rgb[i] = g1c2_rgb[i] = g2c1_rgb[i] = g2c2_rgb[i] = 0.0f;
+
+    w = h = 0;
+
+    // Where in flicker?
+    showingG1 = false;
+
+    setBoxNum(1);
+}
+
+/**
+Set size:
+  Updates the width and height
+*/
+void FlickerPainter::setSize(QSize size)
+{
+    w=size.width(); h=size.height();
+    setBoxNum(numBoxes);
+}
+
+/**
+Set Box Nums:
+  Updates the number of boxes displayed
+*/
+void FlickerPainter::setBoxNum(int num)
+{
+    if(num < 1) num = 1;
+    numBoxes = num;
+
+    wLength = ceil((double)w / numBoxes);
+    hLength = ceil((double)h / numBoxes);
+    steps = 1.0f / (numBoxes > 1 ? (numBoxes-1) : 1); // For var amtC#inC#
+}
+
+/**
+Set various colors:
+  Updates the color in each gradient
+*/
+void FlickerPainter::setColors(int colorVals[]) {
+    for(int i=0; i<12; i+=3) {
+        float* curr_rgb;
+        if(i==0)       curr_rgb = g1c1_rgb;
+        else if(i==3)  curr_rgb = g1c2_rgb;
+        else if(i==6)  curr_rgb = g2c1_rgb;
+        else           curr_rgb = g2c2_rgb;
+
+        curr_rgb[0] = colorVals[i+0] / 255.0;  // R
+        curr_rgb[1] = colorVals[i+1] / 255.0;  // G
+        curr_rgb[2] = colorVals[i+2] / 255.0;  // B
+    }
+}
+
+/**
+Box colors:
+  Neighbouring boxes alternate gradients like a checkerboard, and
+  each row is one step further from c1 towards c2
+*/
+void FlickerPainter::boxColors(int col, int row, bool g1Phase,
+                               float top[3], float bottom[3]) const
+{
+    bool isG1 = g1Phase;
+    if(col % 2 == 1) isG1 = !isG1;
+    if(row % 2 == 1) isG1 = !isG1;
+
+    float amtC2inC1 = row * steps;    // Also amtC1inC2
+    float amtC1inC1 = 1.0f - amtC2inC1; // Also amtC2inC2
+
+    const float* c1 = isG1 ? g1c1_rgb : g2c1_rgb;
+    const float* c2 = isG1 ? g1c2_rgb : g2c2_rgb;
+    for(int i=0; i<3; i++) {
+        top[i] = c1[i]*amtC1inC1 + c2[i]*amtC2inC1;
+        // Gradients run across boxes, not within, unless there is only one
+        bottom[i] = numBoxes == 1 ? c2[i]*amtC1inC1 + c1[i]*amtC2inC1
+                                  : top[i];
+    }
+}
+
+/**
+Box rect:
+  Boxes start on an even split but round their size up,
+  so no gaps are left between them
+*/
+QRect FlickerPainter::boxRect(int col, int row) const
+{
+    return QRect(col*w / numBoxes, row*h / numBoxes, wLength, hLength);
+}
+
+/**
+Paint:
+  Draws every box of the current gradient
+*/
+void FlickerPainter::paint()
+{
+    glClearColor(0.0f, 1.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+
+    glBegin(GL_QUADS);
+    for(int col=0; col < numBoxes; ++col) {
+        for(int row=0; row < numBoxes; ++row) {
+            // Where to begin drawing
+            QRect box = boxRect(col, row);
+
+            float top[3]; float bottom[3];
+            boxColors(col, row, showingG1, top, bottom);
+
+            glColor3f(top[0], top[1], top[2]);
+            glVertex2d(box.x(), box.y());
+            glVertex2d(box.x() + box.width(), box.y());
+
+            glColor3f(bottom[0], bottom[1], bottom[2]);
+            glVertex2d(box.x() + box.width(), box.y() + box.height());
+            glVertex2d(box.x(), box.y() + box.height());
+        }
+    }
+    glEnd();
+
+    glPopMatrix();
+}
@@ -0,0 +1,66 @@
+//This file is part of The Garden Path
+
+//The Garden Path is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//The Garden Path is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with The Garden Path.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef FLICKERPAINTER_H
+#define FLICKERPAINTER_H
+
+#include <QSize>
+#include <QRect>
+
+// Box and gradient math shared by every display.
+// Holds no GL state of its own; paint() expects a current context
+// with a pixel-space orthographic projection.
+class FlickerPainter
+{
+public:
+    FlickerPainter();
+    void setBoxNum(int);
+    void setSize(QSize);
+    void setColors(int vals[12]);
+
+    // Draw the current phase
+    void paint();
+    // Flip to the other phase
+    void advance() { showingG1 = !showingG1; }
+
+    // Colors of box (col, row) in the given phase.
+    // top is the upper edge, bottom the lower edge.
+    void boxColors(int col, int row, bool g1Phase,
+                   float top[3], float bottom[3]) const;
+
+    // Where box (col, row) sits, in pixels
+    QRect boxRect(int col, int row) const;
+
+    int boxNum() const { return numBoxes; }
+    bool isShowingG1() const { return showingG1; }
+
+private:
+    //displays
+    float g1c1_rgb[3];
+    float g1c2_rgb[3];
+    float g2c1_rgb[3];
+    float g2c2_rgb[3];
+
+    int w, h;
+
+    //boxes
+    int numBoxes;
+    int wLength, hLength; // How big each box is
+    float steps; // For updating var amtC#inC#
+
+    bool showingG1;
+};
+
+#endif // FLICKERPAINTER_H
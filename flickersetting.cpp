@@ -1,3 +1,8 @@
+#include <cstdio>
+#include <cstdlib>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
+
 #include "flickersetting.h"
 #include "qdebug.h"
 
@@ -16,3 +21,61 @@ FlickerSetting::FlickerSetting(const char* myName,
     isMaxSpeed = myIsMaxSpeed;
     numBoxes = myNumBoxes;
 }
+
+bool FlickerSetting::readXml(QIODevice* fp, int colors[12], int& speed,
+                             bool& isMaxSpeed, int& numBoxes)
+{
+    QXmlStreamReader xmlr(fp);
+    bool isPresetFile = false; // Don't read random xml's
+    int cindex = 0;
+
+    xmlr.readNext();
+    while(!xmlr.atEnd()) {
+        if(xmlr.isStartElement()) {
+           QString name = xmlr.name().toString();
+           xmlr.readNext();
+           int text = atoi(xmlr.text().toString().toAscii());
+
+           if(name == "FlickerOptions") {
+               isPresetFile = true;
+               continue;
+           } else if(!isPresetFile) {
+               break; // Leave this file, not what we want
+           } else if(name.at(0) == 'c' && cindex < 12) {
+               colors[cindex] = text;
+               ++cindex;
+           } else if(name == "Speed") {
+               speed = text;
+           } else if(name == "NumBoxes") {
+               numBoxes = text;
+           } else if(name == "IsMaxSpeed") {
+               isMaxSpeed = text == 1 ? true : false;
+           }
+        }
+        xmlr.readNext();
+    }
+    return isPresetFile;
+}
+
+void FlickerSetting::writeXml(QIODevice* fp, const int colors[12], int speed,
+                              bool isMaxSpeed, int numBoxes)
+{
+    QXmlStreamWriter xmlWriter(fp);
+    xmlWriter.setAutoFormatting(true);
+    xmlWriter.writeStartDocument();
+
+    xmlWriter.writeStartElement("FlickerOptions");
+
+    // Write 12 colors
+    char colorValText[4]; // Length 4: c12\0
+    for(int i=0; i<12; i++) {
+        sprintf(colorValText, "c%d", i);
+        xmlWriter.writeTextElement(colorValText, QString::number(colors[i]));
+    }
+
+    xmlWriter.writeTextElement("Speed", QString::number(speed));
+    xmlWriter.writeTextElement("NumBoxes", QString::number(numBoxes));
+    xmlWriter.writeTextElement("IsMaxSpeed", isMaxSpeed ? "1" : "0");
+
+    xmlWriter.writeEndDocument();
+}
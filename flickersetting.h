@@ -1,6 +1,8 @@
 #ifndef FLICKERSETTING_H
 #define FLICKERSETTING_H
 
+class QIODevice;
+
 class FlickerSetting
 {
 public:
@@ -13,6 +15,14 @@ public:
     int speed; // Hz
     bool isMaxSpeed; // Max speed activated?
     int numBoxes; // Number of boxes across
+
+    // Read a <FlickerOptions> document. Values missing from the
+    // file are left as passed in. False if fp holds some other xml.
+    static bool readXml(QIODevice* fp, int colors[12], int& speed,
+                        bool& isMaxSpeed, int& numBoxes);
+    // Write a <FlickerOptions> document
+    static void writeXml(QIODevice* fp, const int colors[12], int speed,
+                         bool isMaxSpeed, int numBoxes);
 };
 
 #endif // FLICKERSETTING_H
@@ -0,0 +1,269 @@
+//This file is part of The Garden Path
+
+//The Garden Path is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//The Garden Path is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with The Garden Path.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <cmath>
+#include <QDateTime>
+#include <QFile>
+#include <QTextStream>
+
+#include "framegovernor.h"
+#include "flickerdisplay.h"
+
+#define GOVERNOR_LOG "degradations.log"
+#define WARMUP_FRAMES 30     // Frames measured before predicting
+#define AVERAGE_WEIGHT 0.1   // Weight of the newest frame in the average
+#define MISS_TOLERANCE 1.1   // How far over budget counts as a miss
+#define STALL_BUDGETS 20     // Gaps this many budgets long are pauses,
+                             // not slow frames
+
+/**
+Constructor:
+  Starts measuring; refreshHz is the display's refresh rate
+*/
+FrameGovernor::FrameGovernor(int myRefreshHz, Action myAction)
+{
+    refreshHz = myRefreshHz > 0 ? myRefreshHz : 60;
+    action = myAction;
+    rate = MAX_SPEED_VAL;
+    numBoxes = 1;
+    isDirect = false;
+    trialNumber = 0;
+    isRateChecked = false;
+
+    clock.start();
+    restart();
+}
+
+void FrameGovernor::restart()
+{
+    lastFrameNs = -1;
+    averageMs = 0;
+    frames = 0;
+    missed = 0;
+}
+
+void FrameGovernor::setRate(int hz)
+{
+    if(hz == rate) return;
+    rate = hz;
+    isRateChecked = false;
+    restart();
+}
+
+void FrameGovernor::setBoxNum(int num)
+{
+    if(num == numBoxes) return;
+    numBoxes = num;
+    restart();
+}
+
+void FrameGovernor::setDirect(bool direct)
+{
+    if(direct == isDirect) return;
+    isDirect = direct;
+    restart();
+}
+
+void FrameGovernor::setTrial(const QString& name)
+{
+    trial = name;
+    ++trialNumber;
+    restart();
+}
+
+/**
+Budget:
+  Each phase gets one timer interval, but never less than one refresh
+*/
+double FrameGovernor::budgetMs() const
+{
+    if(rate == MAX_SPEED_VAL || rate >= refreshHz)
+        return 1000.0 / refreshHz;
+    if(rate <= 0)
+        return FlickerDisplay::timerInterval(rate); // What the display waits
+    return 1000.0 / rate;
+}
+
+bool FrameGovernor::isRateUneven() const
+{
+    if(rate == MAX_SPEED_VAL || rate <= 0) return false;
+    return rate > refreshHz || refreshHz % rate != 0;
+}
+
+/**
+Frame done:
+  Times the frame against the budget and steps in once the
+  average says frames will keep missing it
+*/
+void FrameGovernor::frameDone()
+{
+    qint64 now = clock.nsecsElapsed();
+    if(lastFrameNs < 0) {
+        lastFrameNs = now;
+        return;
+    }
+
+    double frameMs = (now - lastFrameNs) / 1000000.0;
+    lastFrameNs = now;
+
+    // Merged updates or alternating 1- and 2-refresh phases keep the
+    // average on budget, so these rates are misses from the start.
+    // Only a lower rate fixes them; anything else just flags the trial.
+    if(!isRateChecked) {
+        isRateChecked = true;
+        if(isRateUneven()) {
+            QString why = rate > refreshHz
+                    ? QString("rate %1Hz above %2Hz refresh").arg(rate).arg(refreshHz)
+                    : QString("rate %1Hz does not divide %2Hz refresh").arg(rate).arg(refreshHz);
+            if(action == LowerRate) {
+                degrade(frameMs, (int)ceil((double)refreshHz / rate), why);
+                return;
+            }
+            record(LogOnly, frameMs, why);
+        }
+    }
+
+    if(frameMs > budgetMs() * STALL_BUDGETS) {
+        // Hidden or paused; what came before says nothing now
+        restart();
+        lastFrameNs = now;
+        return;
+    }
+
+    ++frames;
+    if(frames == 1) averageMs = frameMs;
+    else averageMs += (frameMs - averageMs) * AVERAGE_WEIGHT;
+
+    double budget = budgetMs();
+    if(frameMs > budget * MISS_TOLERANCE) ++missed;
+
+    if(frames >= WARMUP_FRAMES && averageMs > budget * MISS_TOLERANCE) {
+        // A lower rate must take at least one more refresh per phase
+        int current = (rate == MAX_SPEED_VAL || rate > refreshHz) ? refreshHz : rate;
+        int currentDivisor = (int)ceil((double)refreshHz / (current > 0 ? current : 1));
+        int needed = (int)ceil(averageMs * refreshHz / 1000.0);
+        degrade(averageMs, qMax(needed, currentDivisor + 1),
+                QString("%1 of %2 frames missed").arg(missed).arg(frames));
+    }
+}
+
+/**
+Degrade:
+  Takes the configured action, or records why it could not
+*/
+void FrameGovernor::degrade(double frameMs, int minDivisor, const QString& why)
+{
+    switch(action) {
+    case CapBoxes:
+        if(numBoxes > 1) {
+            int capped = numBoxes / 2;
+            record(CapBoxes, frameMs, QString("boxes %1 -> %2, %3")
+                   .arg(numBoxes).arg(capped).arg(why));
+            numBoxes = capped;
+            emit boxNumCapped(capped);
+        } else {
+            record(LogOnly, frameMs, "already 1 box, " + why);
+        }
+        break;
+
+    case LowerRate: {
+        // Only rates that divide the refresh rate keep both phases even
+        int divisor = qMax(1, minDivisor);
+        while(divisor <= refreshHz && refreshHz % divisor != 0) ++divisor;
+
+        if(divisor <= refreshHz) {
+            int lowered = refreshHz / divisor;
+            record(LowerRate, frameMs, QString("rate %1 -> %2Hz, %3")
+                   .arg(rate == MAX_SPEED_VAL ? QString("max") : QString::number(rate))
+                   .arg(lowered).arg(why));
+            rate = lowered;
+            emit rateLowered(lowered);
+        } else {
+            record(LogOnly, frameMs, "no lower rate, " + why);
+        }
+        break;
+    }
+
+    case CheaperPath:
+        if(!isDirect) {
+            record(CheaperPath, frameMs, "switched to direct path, " + why);
+            isDirect = true;
+            emit cheaperPathWanted();
+        } else {
+            record(LogOnly, frameMs, "already on direct path, " + why);
+        }
+        break;
+
+    case LogOnly:
+        record(LogOnly, frameMs, why);
+        break;
+    }
+
+    restart();
+}
+
+/**
+Record:
+  Keeps the event and appends it to the log so the trial can be flagged
+*/
+void FrameGovernor::record(Action taken, double frameMs, const QString& detail)
+{
+    Degradation event;
+    event.atMs = clock.elapsed();
+    event.trialNumber = trialNumber;
+    event.trial = trial;
+    event.action = taken;
+    event.frameMs = frameMs;
+    event.budgetMs = budgetMs();
+    event.detail = detail;
+    events.append(event);
+
+    QString line = QString("%1 trial=%2 \"%3\" action=%4 frame=%5ms budget=%6ms %7")
+            .arg(QDateTime::currentDateTime().toString(Qt::ISODate))
+            .arg(trialNumber)
+            .arg(trial)
+            .arg(actionName(taken))
+            .arg(frameMs, 0, 'f', 2)
+            .arg(event.budgetMs, 0, 'f', 2)
+            .arg(detail);
+    qWarning("Frame budget: %s", qPrintable(line));
+
+    QFile fp(GOVERNOR_LOG);
+    if(fp.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        QTextStream out(&fp);
+        out << line << "\n";
+        fp.close();
+    }
+
+    emit degraded(actionName(taken) + ": " + detail);
+}
+
+FrameGovernor::Action FrameGovernor::actionFromName(const QString& name)
+{
+    if(name == "direct") return CheaperPath;
+    if(name == "boxes") return CapBoxes;
+    if(name == "rate") return LowerRate;
+    return LogOnly;
+}
+
+QString FrameGovernor::actionName(Action a)
+{
+    switch(a) {
+    case CheaperPath: return "direct";
+    case CapBoxes:    return "boxes";
+    case LowerRate:   return "rate";
+    default:          return "log";
+    }
+}
@@ -0,0 +1,106 @@
+//This file is part of The Garden Path
+
+//The Garden Path is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//The Garden Path is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with The Garden Path.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef FRAMEGOVERNOR_H
+#define FRAMEGOVERNOR_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QList>
+#include <QString>
+
+// Watches how long frames really take against the budget the requested
+// rate allows. When frames are predicted to miss it, the phases would
+// come out uneven, so it takes the configured action and records it.
+class FrameGovernor : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Action {
+        LogOnly,     // Only record the event
+        CheaperPath, // Ask for the direct render path
+        CapBoxes,    // Halve the number of boxes
+        LowerRate    // Drop to the next refresh divisor that fits
+    };
+
+    struct Degradation
+    {
+        qint64 atMs;      // Since the governor started
+        int trialNumber;  // Counts setTrial() calls
+        QString trial;    // Preset being shown
+        Action action;    // What was actually done
+        double frameMs;   // Predicted frame time
+        double budgetMs;  // What the rate allows
+        QString detail;
+    };
+
+    explicit FrameGovernor(int refreshHz, Action action);
+
+    // Keep in step with what the display was last told
+    void setRate(int hz);
+    void setBoxNum(int);
+    void setDirect(bool);
+    // Start a new trial; later degradations are recorded against it
+    void setTrial(const QString&);
+
+    // Called by a display after each frame it puts on screen
+    void frameDone();
+
+    const QList<Degradation>& degradations() const { return events; }
+    bool hasDegraded() const { return !events.isEmpty(); }
+    // Anything recorded since the last setTrial()?
+    bool isTrialDegraded() const
+    { return !events.isEmpty() && events.last().trialNumber == trialNumber; }
+
+    // "log", "direct", "boxes" or "rate"; LogOnly if unknown
+    static Action actionFromName(const QString&);
+    static QString actionName(Action);
+
+signals:
+    void degraded(const QString& detail);
+    void boxNumCapped(int);
+    void rateLowered(int);
+    void cheaperPathWanted();
+
+private:
+    // Forget measurements; settings changed or an action was taken
+    void restart();
+    double budgetMs() const;
+    // Rates above refresh, or not dividing it, give uneven phases
+    bool isRateUneven() const;
+    // Act on a predicted miss; a lowered rate uses at least minDivisor
+    void degrade(double frameMs, int minDivisor, const QString& why);
+    void record(Action, double frameMs, const QString& detail);
+
+    QElapsedTimer clock;
+    qint64 lastFrameNs;
+    double averageMs; // Moving average of frame times
+    int frames;       // Measured since restart()
+    int missed;       // Frames over budget since restart()
+    bool isRateChecked; // Current rate checked against refresh yet?
+
+    int refreshHz;
+    Action action;
+    int rate; // Hz, or MAX_SPEED_VAL
+    int numBoxes;
+    bool isDirect;
+    int trialNumber;
+    QString trial;
+
+    QList<Degradation> events;
+};
+
+#endif // FRAMEGOVERNOR_H
@@ -23,10 +23,27 @@ QT += opengl
 
 SOURCES += main.cpp\
         mainwindow.cpp \
-    flickersetting.cpp
+    flickersetting.cpp \
+    flickerpainter.cpp \
+    directflickerer.cpp \
+    multiflickerer.cpp \
+    presetbundle.cpp \
+    presetlistmodel.cpp \
+    stillwriter.cpp \
+    offlinerenderer.cpp \
+    framegovernor.cpp
 
 HEADERS  += mainwindow.h \
-    flickersetting.h
+    flickersetting.h \
+    flickerpainter.h \
+    flickerdisplay.h \
+    directflickerer.h \
+    multiflickerer.h \
+    presetbundle.h \
+    presetlistmodel.h \
+    stillwriter.h \
+    offlinerenderer.h \
+    framegovernor.h
 
 FORMS    += mainwindow.ui
 
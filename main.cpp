@@ -13,18 +13,114 @@
 //You should have received a copy of the GNU General Public License
 //along with The Garden Path.  If not, see <http://www.gnu.org/licenses/>.
 
+#include <cstring>
 #include <QtPlugin>
 #include <QtGui/QApplication>
 //include <QApplication.h>
 #include <QtOpenGL/QGLWidget>
 
 #include "mainwindow.h"
+#include "presetbundle.h"
+#include "offlinerenderer.h"
+#include "framegovernor.h"
+
+static int usage()
+{
+    qWarning("Usage: gardenpath --compile-presets <dir> <bundle.gpb>\n"
+             "       gardenpath --extract-presets <bundle.gpb> <dir>\n"
+             "       gardenpath --render <preset.xml> <W>x<H> <out.png|.tif|.raw>");
+    return 1;
+}
 
 int main(int argc, char *argv[])
 {
-    QApplication a(argc, argv);
-    MainWindow *w = new MainWindow((int)(12.0/60.0 * 10));
+    // Converting presets and rendering stills need no display; without
+    // all their arguments there is nothing to do and no window to fall
+    // back on
+    bool isGui = true;
+    for(int i=1; i<argc; i++) {
+        int needed = 0;
+        if(strcmp(argv[i], "--compile-presets") == 0 ||
+           strcmp(argv[i], "--extract-presets") == 0) needed = 2;
+        else if(strcmp(argv[i], "--render") == 0) needed = 3;
+        else continue;
+
+        if(i+needed >= argc) return usage();
+        isGui = false;
+    }
+
+    QApplication a(argc, argv, isGui);
+    QStringList args = a.arguments();
+
+    // Convert between a presets directory and a compiled bundle:
+    //   --compile-presets <dir> <bundle.gpb>
+    //   --extract-presets <bundle.gpb> <dir>
+    int convertArg = args.indexOf("--compile-presets");
+    if(convertArg >= 0)
+        return PresetBundle::fromXml(args.at(convertArg+1),
+                                     args.at(convertArg+2)) ? 0 : 1;
+    convertArg = args.indexOf("--extract-presets");
+    if(convertArg >= 0)
+        return PresetBundle::toXml(args.at(convertArg+1),
+                                   args.at(convertArg+2)) ? 0 : 1;
+
+    // Render both phases of a preset to still images, any size:
+    //   --render <preset.xml> <W>x<H> <out.png|.tif|.raw>
+    int renderArg = args.indexOf("--render");
+    if(renderArg >= 0) {
+        QStringList dims = args.at(renderArg+2).split('x');
+        bool isWidthOk = false, isHeightOk = false;
+        int width = dims.size() == 2 ? dims.at(0).toInt(&isWidthOk) : 0;
+        int height = dims.size() == 2 ? dims.at(1).toInt(&isHeightOk) : 0;
+        if(!isWidthOk || !isHeightOk || width <= 0 || height <= 0)
+            return usage();
+
+        QFile fp(args.at(renderArg+1));
+        if(!fp.open(QIODevice::ReadOnly)) {
+            qWarning("Cannot open %s", qPrintable(fp.fileName()));
+            return 1;
+        }
+
+        int colors[12] = {0};
+        int speed = 60;
+        bool isMaxSpeed = false;
+        int numBoxes = 1;
+        if(!FlickerSetting::readXml(&fp, colors, speed, isMaxSpeed, numBoxes))
+            return 1;
+
+        FlickerSetting setting("", colors, speed, isMaxSpeed, numBoxes);
+        OfflineRenderer renderer(setting, QSize(width, height));
+        return renderer.renderBoth(args.at(renderArg+3)) ? 0 : 1;
+    }
+
+    // --direct: skip QGraphicsView and draw straight to the GL surface
+    bool isDirect = a.arguments().contains("--direct");
+
+    MainWindow *w = new MainWindow((int)(12.0/60.0 * 10), isDirect);
     w->show();
 
+    // Frame-budget governor, always on so slipped frames are recorded:
+    //   --governor log|direct|boxes|rate   what to do when frames slip
+    //   --refresh <Hz>                     display refresh rate, default 60
+    QString governorAction = "log";
+    int refreshHz = 60;
+    int governorArg = args.indexOf("--governor");
+    if(governorArg >= 0 && governorArg+1 < args.size())
+        governorAction = args.at(governorArg+1);
+    int refreshArg = args.indexOf("--refresh");
+    if(refreshArg >= 0 && refreshArg+1 < args.size())
+        refreshHz = args.at(refreshArg+1).toInt();
+    w->setGovernor(new FrameGovernor(refreshHz,
+                   FrameGovernor::actionFromName(governorAction)));
+
+    // --panels CxR: compare presets side by side, e.g. --panels 4x4
+    int panelsArg = a.arguments().indexOf("--panels");
+    if(panelsArg >= 0 && panelsArg+1 < a.arguments().size()) {
+        QStringList dims = a.arguments().at(panelsArg+1).split('x');
+        if(dims.size() == 2)
+            w->beginMultiPanel(dims.at(0).toInt(), dims.at(1).toInt(),
+                               refreshHz);
+    }
+
     return a.exec();
 }
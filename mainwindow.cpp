@@ -34,7 +34,6 @@
 #include <cstdlib>
 #include <QtGui>
 #include <QtOpenGL/QGLWidget>
-#include <QXmlStreamReader>
 #include <QTimer>
 #include <GL/glu.h>
 #include <qgl.h>
@@ -42,37 +41,32 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
 #include "flickersetting.h"
-
-#define MAX_SPEED_VAL -1
+#include "directflickerer.h"
+#include "multiflickerer.h"
+#include "presetbundle.h"
+#include "presetlistmodel.h"
+#include "framegovernor.h"
 
 
 /**
 Constructor:
   Creates a RedGreenStrip and connects it to the UI
 */
-MainWindow::MainWindow(int timerInterval)
+MainWindow::MainWindow(int timerInterval, bool isDirect)
 {
-    int width = 800; int height = 800;
     isSetMaxSpeed = false;
+    multiView = NULL;
+    governor = NULL;
+    isDragging = false;
+    r = NULL;
+    view = NULL;
+    this->timerInterval = timerInterval;
 
     ui.setupUi(this);
     setWindowTitle("Options");
     setFixedSize(this->size());
 
-    // Set up graphics viewer
-    r = new Flickerer(timerInterval);
-    r->setSize(QSize(width,height));
-    // r->resize(width, height);
-    r->setSceneRect(0, 0, width, height);
-    r->initPainter();
-
-   // scene = new QGraphicsScene(0, 0, width, height);
-   // scene->addWidget(r);
-
-    QGLFormat* fmt = new QGLFormat();
-    fmt->setSwapInterval(1);
-    QGLWidget* w = new QGLWidget(*fmt);
-    // w->setFormat(*fmt);
+    QGLWidget* w = createDisplay(isDirect);
 
     int success = w->format().swapInterval(); // Should be 1 if hardware supports
     if(success != 1) {
@@ -86,22 +80,11 @@ MainWindow::MainWindow(int timerInterval)
         }
     }
 
-    view = new QGraphicsView(r, NULL);
-    view->setViewport(w);
-    view->setViewportUpdateMode(
-            QGraphicsView::FullViewportUpdate);
-    view->resize(width, height);
-    view->setWindowTitle("Finding the Garden Path");
-    view->setMaximumSize(width, height);
-    view->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-    view->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-    view->setResizeAnchor(QGraphicsView::AnchorViewCenter);
-
     // r->setFormat(fmt);
 
     connect( ui.beginButton, SIGNAL(released()), this, SLOT(beginSlot()) );
-    connect( ui.hzSlider, SIGNAL(sliderMoved(int)), this, SLOT(updateTimer()));
-    connect( ui.boxSlider, SIGNAL(sliderMoved(int)), this, SLOT(updateBoxes()));
+    connect( ui.hzSlider, SIGNAL(valueChanged(int)), this, SLOT(updateTimer()));
+    connect( ui.boxSlider, SIGNAL(valueChanged(int)), this, SLOT(updateBoxes()));
     connect( ui.maxSpeed, SIGNAL(released()), this, SLOT(updateMaxSpeed()));
     connect( ui.saveSettings, SIGNAL(released()), this, SLOT(savePreset()));
     connect( ui.refreshSettings, SIGNAL(released()), this, SLOT(refreshPreset()));
@@ -124,9 +107,206 @@ MainWindow::MainWindow(int timerInterval)
     numBoxes = 1;
     presetList = new QList<FlickerSetting>();
     presetText = new QStringList();
+    presetModel = new PresetListModel(presetText, &bundles, this);
+    ui.presetList->setUniformItemSizes(true); // Don't measure every row
+    ui.presetList->setModel(presetModel);
     loadPresets();
-    if(!presetList->isEmpty())
-        loadPreset(presetList->at(0));
+    if(presetCount() > 0) {
+        loadPreset(presetAt(0));
+        currentPreset = presetName(0);
+    }
+}
+
+/**
+Create display:
+  Builds the flicker window, replacing any previous one.
+  Returns the GL widget that ends up drawing it.
+*/
+QGLWidget* MainWindow::createDisplay(bool isDirect)
+{
+    int width = 800; int height = 800;
+    this->isDirect = isDirect;
+
+    QGLFormat* fmt = new QGLFormat();
+    fmt->setSwapInterval(1);
+    QGLWidget* w;
+
+    if(isDirect) {
+        // Own GL context and swap loop, nothing in between
+        DirectFlickerer* d = new DirectFlickerer(*fmt, timerInterval);
+        r = d;
+        w = d;
+        view = d;
+    } else {
+        // Set up graphics viewer
+        Flickerer* scene = new Flickerer(timerInterval);
+        scene->setSize(QSize(width,height));
+        // r->resize(width, height);
+        scene->setSceneRect(0, 0, width, height);
+        scene->initPainter();
+        r = scene;
+
+       // scene = new QGraphicsScene(0, 0, width, height);
+       // scene->addWidget(r);
+
+        w = new QGLWidget(*fmt);
+        // w->setFormat(*fmt);
+
+        QGraphicsView* graphicsView = new QGraphicsView(scene, NULL);
+        graphicsView->setViewport(w);
+        graphicsView->setViewportUpdateMode(
+                QGraphicsView::FullViewportUpdate);
+        graphicsView->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+        graphicsView->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+        graphicsView->setResizeAnchor(QGraphicsView::AnchorViewCenter);
+        view = graphicsView;
+    }
+
+    view->resize(width, height);
+    view->setWindowTitle("Finding the Garden Path");
+    view->setMaximumSize(width, height);
+
+    r->setGovernor(governor);
+    if(governor) governor->setDirect(isDirect);
+
+    return w;
+}
+
+/**
+Set governor:
+  Watches the display's frame times from now on
+*/
+void MainWindow::setGovernor(FrameGovernor* g)
+{
+    governor = g;
+    r->setGovernor(governor);
+
+    // Queued: these fire from inside a paint
+    connect( governor, SIGNAL(degraded(QString)), this, SLOT(showDegraded(QString)), Qt::QueuedConnection );
+    connect( governor, SIGNAL(boxNumCapped(int)), this, SLOT(capBoxes(int)), Qt::QueuedConnection );
+    connect( governor, SIGNAL(rateLowered(int)), this, SLOT(lowerRate(int)), Qt::QueuedConnection );
+    connect( governor, SIGNAL(cheaperPathWanted()), this, SLOT(useDirectPath()), Qt::QueuedConnection );
+
+    // Any stimulus change by hand makes a new trial: drags, track
+    // clicks, keys and the wheel all trigger slider actions
+    QAbstractSlider* sliders[14] = {ui.hzSlider, ui.boxSlider};
+    for(int i=0; i<12; i++)
+        sliders[i+2] = colorList[i];
+    for(int i=0; i<14; i++) {
+        connect( sliders[i], SIGNAL(actionTriggered(int)), this, SLOT(stimulusChanged(int)) );
+        connect( sliders[i], SIGNAL(sliderReleased()), this, SLOT(stimulusSettled()) );
+    }
+    connect( ui.maxSpeed, SIGNAL(released()), this, SLOT(stimulusChanged()) );
+
+    governor->setDirect(isDirect);
+    startTrial(currentPreset);
+    updateAll();
+}
+
+/**
+Start trial:
+  Later degradations are recorded against the new trial
+*/
+void MainWindow::startTrial(const QString& name)
+{
+    if(!governor) return;
+    governor->setTrial(name);
+    showTrialState();
+}
+
+/**
+Stimulus changed / settled:
+  The sliders no longer show the preset as saved.
+  A drag starts one trial when it begins, not one per step.
+*/
+void MainWindow::stimulusChanged(int action)
+{
+    QAbstractSlider* slider = qobject_cast<QAbstractSlider*>(sender());
+    if(action == QAbstractSlider::SliderMove && slider && slider->isSliderDown()) {
+        if(isDragging) return;
+        isDragging = true;
+    }
+    startTrial(currentPreset + " (edited)");
+}
+void MainWindow::stimulusSettled()
+{
+    isDragging = false;
+}
+
+/**
+Show degraded:
+  Flags the trial so its data is not taken at face value.
+  Queued, so the event may belong to a trial already over.
+*/
+void MainWindow::showDegraded(QString)
+{
+    showTrialState();
+}
+
+/**
+Show trial state:
+  Flagged only while the current trial has degradations
+*/
+void MainWindow::showTrialState()
+{
+    if(governor && governor->isTrialDegraded()) {
+        const FrameGovernor::Degradation& last = governor->degradations().last();
+        statusBar()->showMessage("Degraded: " + FrameGovernor::actionName(last.action)
+                                 + ": " + last.detail);
+        view->setWindowTitle("Finding the Garden Path [degraded]");
+    } else {
+        statusBar()->clearMessage();
+        view->setWindowTitle("Finding the Garden Path");
+    }
+}
+
+/**
+Cap boxes / Lower rate:
+  Governor actions, applied through the sliders so they show.
+  Signals are blocked so they are not taken for edits by hand.
+*/
+void MainWindow::capBoxes(int num)
+{
+    ui.boxSlider->blockSignals(true);
+    ui.boxSlider->setSliderPosition(num);
+    ui.boxSlider->blockSignals(false);
+    updateBoxes();
+}
+void MainWindow::lowerRate(int hz)
+{
+    if(isSetMaxSpeed) updateMaxSpeed(); // Back to a custom speed
+    ui.hzSlider->blockSignals(true);
+    ui.hzSlider->setSliderPosition(hz);
+    ui.hzSlider->blockSignals(false);
+    updateTimer();
+}
+
+/**
+Use direct path:
+  Swaps the scene-based display for the direct one in place
+*/
+void MainWindow::useDirectPath()
+{
+    if(isDirect) return;
+
+    bool wasVisible = view->isVisible();
+    QPoint pos = view->pos();
+
+    QWidget* oldView = view;
+    QObject* oldScene = dynamic_cast<QObject*>(r);
+    r->setGovernor(NULL);
+    oldView->close();
+    oldView->deleteLater();
+    oldScene->deleteLater();
+
+    createDisplay(true);
+    showTrialState();
+    updateAll();
+
+    if(wasVisible) {
+        view->move(pos);
+        view->show();
+    }
 }
 
 /**
@@ -149,6 +329,7 @@ void MainWindow::updateBoxes()
 {
     numBoxes = ui.boxSlider->sliderPosition();
     r->setBoxNum(numBoxes);
+    if(governor) governor->setBoxNum(numBoxes);
 
     ui.numBoxes->setText(QString::number(numBoxes));
 }
@@ -161,6 +342,7 @@ void MainWindow::updateTimer()
 {
     int fps = ui.hzSlider->sliderPosition();
     r->setTimer(fps); // In frames per second
+    if(governor) governor->setRate(fps);
 
     ui.Hztext->setText(QString::number(fps) + "fps");
 }
@@ -194,6 +376,7 @@ void MainWindow::updateMaxSpeed(bool hasChanged)
 
     if(isSetMaxSpeed) {
         r->setTimer(MAX_SPEED_VAL);
+        if(governor) governor->setRate(MAX_SPEED_VAL);
         ui.hzSlider->setEnabled(false);
         ui.Hztext->setText("Max");
         ui.maxSpeed->setText("Custom Speed");
@@ -210,67 +393,87 @@ Load Presets: Load list of presets
 */
 void MainWindow::loadPresets()
 {
-    char* fileName;
     QFile* fp;
-    QXmlStreamReader xmlr;
+    QDir dir("presets");
+
+    // Compiled bundles are used in place, without parsing;
+    // the list reads their names straight from the mapping
+    QStringList bundleTypes;
+    bundleTypes << "*.gpb";
+    QFileInfoList bundleList = QDir().entryInfoList(bundleTypes);
+    bundleList.append(dir.entryInfoList(bundleTypes));
+
+    QList<QDateTime> bundleTimes;
+    for(int i=0; i<bundleList.size(); ++i) {
+        PresetBundle* bundle = new PresetBundle();
+        if(!bundle->open(bundleList.at(i).absoluteFilePath())) {
+            delete bundle;
+            continue;
+        }
+
+        bundles.append(bundle);
+        bundleTimes.append(bundleList.at(i).lastModified());
+    }
 
     // Get all .xml files
     QStringList fileTypes;
     fileTypes << "*.xml";
-    QDir dir;
-    QFileInfoList fileList = dir.entryInfoList(fileTypes);
-    dir.setPath("presets");
+    QFileInfoList fileList = QDir().entryInfoList(fileTypes);
     fileList.append(dir.entryInfoList(fileTypes));
 
     for(int i=0; i<fileList.size(); ++i) {
         QFileInfo fileInfo = fileList.at(i);
-        fileName = fileInfo.absoluteFilePath().toAscii().data();
-        fp = new QFile(fileName);
-        if(!fp->exists()) break;
 
-        if(!fp->open(QIODevice::ReadOnly)) {
+        // Already listed from a bundle compiled since it was saved
+        QByteArray asciiName = fileInfo.baseName().toAscii();
+        bool isBundled = false;
+        for(int b=0; !isBundled && b<bundles.size(); ++b)
+            isBundled = bundles.at(b)->indexOf(asciiName.constData()) >= 0
+                    && bundleTimes.at(b) >= fileInfo.lastModified();
+        if(isBundled) continue;
+
+        fp = new QFile(fileInfo.absoluteFilePath());
+        if(!fp->exists() || !fp->open(QIODevice::ReadOnly)) {
             qDebug("Unexpected error opening preset!");
-            return;
+            delete fp;
+            continue;
         }
 
         QString name = QString(fileInfo.baseName());
 
-        bool isPresetFile = false; // Don't read random xml's
-        xmlr.setDevice(fp);
-        xmlr.readNext();
-
         // Initialize with default vals
-        int colors[12]; int cindex = 0;
+        int colors[12] = {0};
         int speed = 60;
         isSetMaxSpeed = false;
 
-        while(!xmlr.atEnd()) {
-            if(xmlr.isStartElement()) {
-               QString name = xmlr.name().toString();
-               xmlr.readNext();
-               int text = atoi(xmlr.text().toString().toAscii());
-
-               if(name == "FlickerOptions") {
-                   isPresetFile = true;
-                   continue;
-               } else if(!isPresetFile) {
-                   break; // Leave this file, not what we want
-               } else if(name.at(0) == 'c') {
-                   colors[cindex] = text;
-                   ++cindex;
-               } else if(name == "Speed") {
-                   speed = text;
-               } else if(name == "NumBoxes") {
-                   numBoxes = text;
-               } else if(name == "IsMaxSpeed") {
-                   isSetMaxSpeed = text == 1 ? true : false;
-               }
-            }
-            xmlr.readNext();
-        }
-        addPresets(name.toAscii(), colors, speed);
+        if(FlickerSetting::readXml(fp, colors, speed, isSetMaxSpeed, numBoxes))
+            addPresets(name.toAscii(), colors, speed);
         fp->close();
+        delete fp;
     }
+
+    presetModel->refresh();
+}
+
+/**
+Preset count / at / name:
+  XML presets come first, then each bundle's, as in the list
+*/
+int MainWindow::presetCount() const
+{
+    return presetModel->rowCount();
+}
+
+FlickerSetting MainWindow::presetAt(int row) const
+{
+    int bundleRow;
+    PresetBundle* bundle = presetModel->bundleAt(row, &bundleRow);
+    return bundle ? bundle->setting(bundleRow) : presetList->at(row);
+}
+
+QString MainWindow::presetName(int row) const
+{
+    return presetModel->data(presetModel->index(row), Qt::DisplayRole).toString();
 }
 
 
@@ -281,6 +484,11 @@ void MainWindow::clearPresets()
 {
     presetList->clear();
     presetText->clear();
+
+    // Bundle presets point into these, so only now unmap them
+    qDeleteAll(bundles);
+    bundles.clear();
+    presetModel->refresh();
 }
 
 
@@ -305,8 +513,6 @@ void MainWindow::addPresets(const char* name,
 
     presetList->append(preset);
     *presetText << name;
-
-    ui.presetList->setModel(new QStringListModel(*presetText)); // Append to preset list
 }
 
 
@@ -327,24 +533,12 @@ void MainWindow::savePreset()
         qDebug("Unexpected error saving preset");
         return;
     }
-    QXmlStreamWriter xmlWriter(fp);
-    xmlWriter.setAutoFormatting(true);
-    xmlWriter.writeStartDocument();
-
-    xmlWriter.writeStartElement("FlickerOptions");
-
-    // Write 12 colors
-    char colorValText[4]; // Length 4: c12\0
-    for(int i=0; i<12; i++) {
-        sprintf(colorValText, "c%d", i);
-        xmlWriter.writeTextElement(colorValText, QString::number(colorList[i]->value()));
-    }
-
-    xmlWriter.writeTextElement("Speed", QString::number(ui.hzSlider->value()));
-    xmlWriter.writeTextElement("NumBoxes", QString::number(ui.boxSlider->value()));
-    xmlWriter.writeTextElement("IsMaxSpeed", isSetMaxSpeed ? "1" : "0");
+    int colorVals[12];
+    for(int i=0; i<12; i++)
+        colorVals[i] = colorList[i]->value();
 
-    xmlWriter.writeEndDocument();
+    FlickerSetting::writeXml(fp, colorVals, ui.hzSlider->value(),
+                             isSetMaxSpeed, ui.boxSlider->value());
     fp->close();
 
     // Reload
@@ -358,7 +552,12 @@ Change Presets: Switch to a different preset
 void MainWindow::changePreset(QModelIndex modelIndex)
 {
     int row = modelIndex.row();
-    loadPreset(presetList->at(row));
+    if(row < 0 || row >= presetCount()) return;
+    loadPreset(presetAt(row));
+
+    // Each preset shown is a new trial
+    currentPreset = presetName(row);
+    startTrial(currentPreset);
 }
 
 /**
@@ -366,6 +565,13 @@ Load preset: Loads the settings provided
   */
 void MainWindow::loadPreset(FlickerSetting settings)
 {
+    // Not an edit by hand; updateAll() below applies it all at once
+    QAbstractSlider* sliders[14] = {ui.hzSlider, ui.boxSlider};
+    for(int i=0; i<12; i++)
+        sliders[i+2] = colorList[i];
+    for(int i=0; i<14; i++)
+        sliders[i]->blockSignals(true);
+
     // Fps
     ui.hzSlider->setSliderPosition(settings.speed);
 
@@ -382,6 +588,8 @@ void MainWindow::loadPreset(FlickerSetting settings)
     numBoxes = settings.numBoxes;
     ui.boxSlider->setSliderPosition(numBoxes);
 
+    for(int i=0; i<14; i++)
+        sliders[i]->blockSignals(false);
     updateAll();
 }
 
@@ -399,6 +607,58 @@ void MainWindow::beginSlot()
     update();
 }
 
+/**
+Begin multi-panel:
+  Shows every preset at once, one panel each, in a single window
+*/
+void MainWindow::beginMultiPanel(int cols, int rows, int refreshHz)
+{
+    QGLFormat fmt;
+    fmt.setSwapInterval(1);
+    MultiFlickerer* wall = new MultiFlickerer(fmt, cols, rows, refreshHz);
+
+    int success = wall->format().swapInterval(); // Should be 1 if hardware supports
+    if(success != 1) {
+        qDebug("Hardware does not support vsync.");
+        QMessageBox warning(QMessageBox::Warning, "Error",
+                            "Your hardware cannot properly display this illusion.",
+                            QMessageBox::Ignore | QMessageBox::Abort,
+                            this);
+        if(warning.exec() == QMessageBox::Abort) {
+            delete wall;
+            return;
+        }
+    }
+
+    if(presetCount() == 0) {
+        // Nothing saved yet, so repeat what the sliders show
+        int colorVals[12];
+        for(int i=0; i<12; i++)
+            colorVals[i] = colorList[i]->value();
+        QList<FlickerSetting> current;
+        current << FlickerSetting("Current", colorVals,
+                                  ui.hzSlider->value(), isSetMaxSpeed,
+                                  numBoxes);
+        wall->setPanels(current);
+    } else {
+        // Only as many as fit; a bundle may hold far more
+        QList<FlickerSetting> shown;
+        for(int i=0; i < qMin(presetCount(), cols*rows); ++i)
+            shown << presetAt(i);
+        wall->setPanels(shown);
+    }
+
+    wall->resize(800, 800);
+    QString title = "Finding the Garden Path";
+    if(!wall->roundedRateNotes().isEmpty())
+        title += " [rounded " + wall->roundedRateNotes().join(", ") + "]";
+    wall->setWindowTitle(title);
+    wall->move(x()+width()+10,y());
+    wall->show();
+
+    multiView = wall;
+}
+
 /**
 ShowBeginButton:
   When display window closes, reshow the begin button
@@ -413,6 +673,7 @@ Close:
 */
 void MainWindow::closeEvent(QCloseEvent *) {
     view->close();
+    if(multiView) multiView->close();
 }
 
 /**
@@ -430,9 +691,6 @@ Flickerer::Flickerer(int timerInterval)
         m_timer->start( timerInterval );
     }
 
-    // Where in flicker?
-    showingG1 = false;
-
     setBoxNum(1);
 }
 
@@ -442,7 +700,7 @@ Initialize painter:
 */
 void Flickerer::initPainter()
 {
-    w = width(); h = height();
+    painter.setSize(QSize(width(), height()));
 }
 
 /**
@@ -462,7 +720,7 @@ Set size:
 */
 void Flickerer::setSize(QSize size)
 {
-    w=size.width(); h=size.height();
+    painter.setSize(size);
 }
 
 /**
@@ -471,11 +729,7 @@ Set timer:
 */
 void Flickerer::setTimer(int hz)
 {
-    int val;
-    if(hz==MAX_SPEED_VAL) val = 0;
-    else if(hz <= 0) val = 100000;
-    else val = 1000.0 / hz;
-    m_timer->setInterval(val);
+    m_timer->setInterval(timerInterval(hz));
 }
 
 /**
@@ -484,12 +738,7 @@ Set Box Nums:
 */
 void Flickerer::setBoxNum(int num)
 {
-    if(num < 1) num = 1;
-    numBoxes = num;
-
-    wLength = ceil((double)w / numBoxes);
-    hLength = ceil((double)h / numBoxes);
-    steps = 1.0f / (numBoxes > 1 ? (numBoxes-1) : 1); // For var amtC#inC#
+    painter.setBoxNum(num);
 }
 
 /**
@@ -497,87 +746,28 @@ Set various colors:
   Updates the color in each gradient
 */
 void Flickerer::setColors(int colorVals[]) {
-    for(int i=0; i<12; i+=3) {
-        float* curr_rgb;
-        if(i==0)       curr_rgb = g1c1_rgb;
-        else if(i==3)  curr_rgb = g1c2_rgb;
-        else if(i==6)  curr_rgb = g2c1_rgb;
-        else           curr_rgb = g2c2_rgb;
-
-        curr_rgb[0] = colorVals[i+0] / 255.0;  // R
-        curr_rgb[1] = colorVals[i+1] / 255.0;  // G
-        curr_rgb[2] = colorVals[i+2] / 255.0;  // B
-    }
+    painter.setColors(colorVals);
 }
 
 /**
 drawBackground
   The openGL scene to be placed in the viewport
 */
-void Flickerer::drawBackground(QPainter *painter,
+void Flickerer::drawBackground(QPainter *qpainter,
                                    const QRectF &)
 {
 //    qDebug("Drawing background");
 
-//    if (painter->paintEngine()->type() != QPaintEngine::OpenGL
-//        && painter->paintEngine()->type() != QPaintEngine::OpenGL2)
+//    if (qpainter->paintEngine()->type() != QPaintEngine::OpenGL
+//        && qpainter->paintEngine()->type() != QPaintEngine::OpenGL2)
 //        qWarning("OpenGLScene: drawBackground needs a QGLWidget to be set as viewport on the graphics view");
 
-    bool startedWithG1 = showingG1;
-
-    painter->beginNativePainting();
-    glClearColor(0.0f, 1.0f, 0.0f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-    glMatrixMode(GL_MODELVIEW);
-    glPushMatrix();
-    glLoadIdentity();
-
-    for(int col=0; col < numBoxes; ++col) {
-        if(col % 2 == 0)
-            showingG1 = startedWithG1;
-        else
-            showingG1 = !startedWithG1;
-
-        float amtC2inC1 = 0.0f; // Also amtC1inC2
-        float amtC1inC1 = 1.0f; // Also amtC2inC2
-
-        for(int row=0; row < numBoxes; ++row) {
-            // Where to begin drawing
-            int wStart = col*w / numBoxes;
-            int hStart = row*h / numBoxes;
+    qpainter->beginNativePainting();
+    painter.paint();
+    qpainter->endNativePainting();
 
-            glBegin(GL_QUADS);
-
-            float* c1 = showingG1 ? g1c1_rgb : g2c1_rgb;
-            float* c2 = showingG1 ? g1c2_rgb : g2c2_rgb;
-            float currC1[3]; float currC2[3];
-            for(int i=0; i<3; i++) {
-                currC1[i] = c1[i]*amtC1inC1 + c2[i]*amtC2inC1;
-                currC2[i] = c2[i]*amtC1inC1 + c1[i]*amtC2inC1;
-            }
-
-            glColor3f(currC1[0], currC1[1], currC1[2]);
-            glVertex2d(wStart, hStart);
-            glVertex2d(wStart + wLength, hStart);
-
-            if(numBoxes == 1)
-                glColor3f(currC2[0], currC2[1], currC2[2]);
-            glVertex2d(wStart + wLength, hStart + hLength);
-            glVertex2d(wStart, hStart + hLength);
-
-            glEnd();
-
-
-            // How true to the c1/c2 gradient this row is
-            amtC2inC1 += steps;      // Also amtC1inC2
-            amtC1inC1 -= steps; // Also amtC2inC2
-
-            showingG1 = !showingG1;
-        }
-    }
-    glPopMatrix();
-    painter->endNativePainting();
+    painter.advance();
 
-    showingG1 = !startedWithG1;
+    // Frames merged by update() show up here as long ones
+    if(governor) governor->frameDone();
 }
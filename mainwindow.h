@@ -24,14 +24,18 @@
 
 #include "ui_mainwindow.h"
 #include "flickersetting.h"
+#include "flickerdisplay.h"
+#include "flickerpainter.h"
+#include "presetbundle.h"
+#include "presetlistmodel.h"
+#include "framegovernor.h"
 
-class Flickerer : public QGraphicsScene
+class Flickerer : public QGraphicsScene, public FlickerDisplay
 {
     Q_OBJECT
 
 public:
     explicit Flickerer(int timerInterval);
-    void paintGL();
     void drawBackground(QPainter*, const QRectF&);
     void setTimer(int);
     void setBoxNum(int);
@@ -44,20 +48,8 @@ private:
     //used to refresh the scene at a given interval
     QTimer *m_timer;
 
-    //displays
-    float g1c1_rgb[3];
-    float g1c2_rgb[3];
-    float g2c1_rgb[3];
-    float g2c2_rgb[3];
-
-    int w, h;
-
-    //boxes
-    int numBoxes;
-    int wLength, hLength; // How big each box is
-    float steps; // For updating var amtC#inC#
-
-    bool showingG1;
+    //box and gradient math
+    FlickerPainter painter;
 
 public slots:
   //slot used to refresh scene when invoked by m_timer
@@ -70,14 +62,26 @@ class MainWindow : public QMainWindow
     Q_OBJECT
 
 public:
-    explicit MainWindow(int timerInterval);
+    // If isDirect, render straight to a GL surface instead of a QGraphicsView
+    explicit MainWindow(int timerInterval, bool isDirect = false);
     Ui::MainWindow ui;
+    // Show the presets side by side in a cols x rows wall
+    void beginMultiPanel(int cols, int rows, int refreshHz = 60);
+    // Watch frame times and degrade as configured when they slip
+    void setGovernor(FrameGovernor*);
 
 private:
     // Display
-    Flickerer *r;
-    QGraphicsView *view;
-    QGraphicsScene* scene;
+    FlickerDisplay *r;
+    QWidget *view;
+    QWidget *multiView;
+    FrameGovernor *governor;
+    QString currentPreset; // Trial name for the governor
+    bool isDragging; // One drag is one edit, however far it goes
+    bool isDirect;
+    int timerInterval;
+    // Build the flicker window; returns the GL widget drawing it
+    QGLWidget* createDisplay(bool isDirect);
     QSlider* colorList[12];
     QLineEdit* colorTextList[12];
     QMessageBox* errmsg;
@@ -87,6 +91,13 @@ private:
 
     QList<FlickerSetting>* presetList;
     QStringList* presetText;
+    // Mapped bundles; their presets' names point into them
+    QList<PresetBundle*> bundles;
+    PresetListModel* presetModel;
+    // Presets by list row, read from a bundle only when asked for
+    int presetCount() const;
+    FlickerSetting presetAt(int row) const;
+    QString presetName(int row) const;
     // Load all presets from disk
     void loadPresets();
     // Add a single preset to preset list
@@ -95,6 +106,10 @@ private:
                     int speed);
     // Set up a single preset to display
     void loadPreset(FlickerSetting);
+    // Tell the governor a new trial began and clear the old flag
+    void startTrial(const QString& name);
+    // Title and status bar say whether this trial degraded
+    void showTrialState();
     // Clear presets for reloading
     void clearPresets();
 
@@ -110,6 +125,12 @@ public slots:
     void showBeginButton(); // Redisplay the begin button
     void savePreset();
     void refreshPreset();
+    void showDegraded(QString);
+    void capBoxes(int);
+    void lowerRate(int);
+    void useDirectPath();
+    void stimulusChanged(int action = QAbstractSlider::SliderNoAction);
+    void stimulusSettled();
 };
 
 #endif // MAINWINDOW_H
@@ -0,0 +1,213 @@
+//This file is part of The Garden Path
+
+//The Garden Path is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//The Garden Path is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with The Garden Path.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <cstring>
+
+#include "multiflickerer.h"
+
+/**
+Constructor:
+  Creates a timer that draws once per refresh;
+  each panel decides from the frame count whether it flips
+*/
+MultiFlickerer::MultiFlickerer(const QGLFormat& fmt, int myCols, int myRows,
+                               int myRefreshHz)
+    : QGLWidget(fmt)
+{
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setAttribute(Qt::WA_NoSystemBackground);
+    setAutoFillBackground(false);
+
+    cols = myCols < 1 ? 1 : myCols;
+    rows = myRows < 1 ? 1 : myRows;
+    refreshHz = myRefreshHz > 0 ? myRefreshHz : 60;
+    frameCount = 0;
+
+    // Vsync paces a zero interval; without it, don't spin a core
+    int interval = format().swapInterval() == 1 ? 0 : 1000 / refreshHz;
+
+    m_timer = new QTimer( this );
+    connect( m_timer, SIGNAL(timeout()), this, SLOT(timeOutSlot()) );
+    m_timer->start( interval );
+}
+
+/**
+Set panels:
+  Loads one preset into each panel
+*/
+void MultiFlickerer::setPanels(const QList<FlickerSetting>& settings)
+{
+    panels.clear();
+    roundedRates.clear();
+    if(settings.isEmpty()) {
+        rebuild();
+        return;
+    }
+
+    for(int i=0; i < cols*rows; ++i) {
+        FlickerSetting setting = settings.at(i % settings.size());
+
+        Panel panel;
+        panel.painter.setColors(setting.colorVals);
+        panel.painter.setBoxNum(setting.numBoxes);
+        // Sampling a wall clock at vsync would repeat or skip phases
+        // whenever the rate sits on a refresh boundary
+        if(setting.isMaxSpeed)
+            panel.framesPerFlip = 1;
+        else if(setting.speed <= 0)
+            panel.framesPerFlip = 0;
+        else
+            panel.framesPerFlip = qMax(1, qRound((double)refreshHz / setting.speed));
+
+        // Rates that don't divide the refresh rate can't be shown as set
+        if(!setting.isMaxSpeed && setting.speed > 0
+           && setting.speed * panel.framesPerFlip != refreshHz) {
+            QString note = QString("panel %1: %2Hz as %3Hz")
+                    .arg(i + 1).arg(setting.speed)
+                    .arg(QString::number((double)refreshHz / panel.framesPerFlip, 'g', 3));
+            qWarning("Multi-panel rate rounded, %s", qPrintable(note));
+            roundedRates << note;
+        }
+
+        panel.vertStart = panel.vertCount = 0;
+        panels.append(panel);
+    }
+
+    rebuild();
+}
+
+/**
+Rebuild:
+  Lays out every box of every panel into one set of arrays
+*/
+void MultiFlickerer::rebuild()
+{
+    vertices.clear();
+    phaseColors[0].clear();
+    phaseColors[1].clear();
+
+    int panelW = width() / cols;
+    int panelH = height() / rows;
+
+    for(int i=0; i < panels.size(); ++i) {
+        Panel& panel = panels[i];
+        panel.painter.setSize(QSize(panelW, panelH));
+
+        int xOffset = (i % cols) * panelW;
+        int yOffset = (i / cols) * panelH;
+        int numBoxes = panel.painter.boxNum();
+        panel.vertStart = vertices.size() / 2;
+
+        for(int col=0; col < numBoxes; ++col) {
+            for(int row=0; row < numBoxes; ++row) {
+                // Keep boxes rounded up at the edge inside their panel
+                QRect box = panel.painter.boxRect(col, row)
+                        .translated(xOffset, yOffset)
+                        .intersected(QRect(xOffset, yOffset, panelW, panelH));
+
+                GLfloat x0 = box.x(), x1 = box.x() + box.width();
+                GLfloat y0 = box.y(), y1 = box.y() + box.height();
+                GLfloat quad[8] = { x0, y0,  x1, y0,  x1, y1,  x0, y1 };
+                for(int v=0; v<8; v++)
+                    vertices.append(quad[v]);
+
+                // Phase 0 is the one a fresh Flickerer shows first
+                for(int phase=0; phase<2; phase++) {
+                    float top[3]; float bottom[3];
+                    panel.painter.boxColors(col, row, phase == 1, top, bottom);
+                    for(int corner=0; corner<4; corner++) {
+                        float* c = corner < 2 ? top : bottom;
+                        phaseColors[phase].append(c[0]);
+                        phaseColors[phase].append(c[1]);
+                        phaseColors[phase].append(c[2]);
+                    }
+                }
+            }
+        }
+
+        panel.vertCount = vertices.size() / 2 - panel.vertStart;
+    }
+
+    colors = phaseColors[0];
+}
+
+/**
+Initialize GL:
+  Everything is drawn from client-side arrays
+*/
+void MultiFlickerer::initializeGL()
+{
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_BLEND);
+    glDisable(GL_DITHER);
+    glShadeModel(GL_SMOOTH);
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+}
+
+/**
+Resize GL:
+  Pixel-space projection with the origin at the top left
+*/
+void MultiFlickerer::resizeGL(int width, int height)
+{
+    glViewport(0, 0, width, height);
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    glOrtho(0, width, height, 0, -1, 1);
+    glMatrixMode(GL_MODELVIEW);
+    glLoadIdentity();
+
+    rebuild();
+}
+
+/**
+Paint GL:
+  One draw call for the whole wall
+*/
+void MultiFlickerer::paintGL()
+{
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    if(vertices.isEmpty()) return;
+
+    glVertexPointer(2, GL_FLOAT, 0, vertices.constData());
+    glColorPointer(3, GL_FLOAT, 0, colors.constData());
+    glDrawArrays(GL_QUADS, 0, vertices.size() / 2);
+}
+
+/**
+Timeout Slot:
+  Picks every panel's phase from the shared frame count, then draws
+*/
+void MultiFlickerer::timeOutSlot()
+{
+    for(int i=0; i < panels.size(); ++i) {
+        const Panel& panel = panels.at(i);
+
+        qint64 flips = panel.framesPerFlip > 0
+                ? frameCount / panel.framesPerFlip : 0;
+
+        int offset = panel.vertStart * 3;
+        memcpy(colors.data() + offset,
+               phaseColors[flips % 2].constData() + offset,
+               panel.vertCount * 3 * sizeof(GLfloat));
+    }
+
+    updateGL();
+    ++frameCount;
+}
@@ -0,0 +1,80 @@
+//This file is part of The Garden Path
+
+//The Garden Path is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//The Garden Path is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with The Garden Path.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef MULTIFLICKERER_H
+#define MULTIFLICKERER_H
+
+#include <QtOpenGL/QGLWidget>
+#include <QTimer>
+#include <QVector>
+#include <QList>
+#include <QStringList>
+
+#include "flickersetting.h"
+#include "flickerpainter.h"
+
+// A cols x rows wall of presets sharing one context, one frame counter
+// and one draw call per frame. Each panel flips every so many refreshes.
+class MultiFlickerer : public QGLWidget
+{
+    Q_OBJECT
+
+public:
+    // refreshHz is the display's refresh rate; panel rates are rounded
+    // to a whole number of refreshes per phase
+    explicit MultiFlickerer(const QGLFormat& fmt, int cols, int rows,
+                            int refreshHz);
+    // Fills the wall in row order, repeating settings if there are too few
+    void setPanels(const QList<FlickerSetting>&);
+    // Panels whose rate had to be rounded, as "panel n: set as shown"
+    const QStringList& roundedRateNotes() const { return roundedRates; }
+
+protected:
+    void initializeGL();
+    void resizeGL(int, int);
+    void paintGL();
+
+private:
+    struct Panel
+    {
+        FlickerPainter painter;
+        int framesPerFlip; // Refreshes per phase; 0 never flips
+        int vertStart, vertCount; // Slice of the vertex arrays
+    };
+
+    // Recompute vertices and both phases' colors after a change
+    void rebuild();
+
+    //used to draw the next frame; vsync paces it
+    QTimer *m_timer;
+
+    // Shared counter every panel's phase is taken from
+    qint64 frameCount;
+
+    int cols, rows;
+    int refreshHz;
+    QList<Panel> panels;
+    QStringList roundedRates;
+
+    QVector<GLfloat> vertices; // x, y per vertex
+    QVector<GLfloat> phaseColors[2]; // r, g, b per vertex, per phase
+    QVector<GLfloat> colors; // What this frame shows
+
+public slots:
+  //slot used to draw the next frame when invoked by m_timer
+  void timeOutSlot();
+};
+
+#endif // MULTIFLICKERER_H
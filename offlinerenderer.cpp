@@ -0,0 +1,184 @@
+//This file is part of The Garden Path
+
+//The Garden Path is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//The Garden Path is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with The Garden Path.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <QFileInfo>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QVector>
+
+#include "offlinerenderer.h"
+#include "stillwriter.h"
+
+#define DEFAULT_TILE_SIZE 128
+
+// One tile of a band, shaded on the pool
+class TileJob : public QRunnable
+{
+public:
+    TileJob(const OfflineRenderer* myRenderer, int myX, int myY,
+            int myW, int myH, bool myG1Phase, float* myOut, int myStride)
+    {
+        renderer = myRenderer;
+        x = myX; y = myY; w = myW; h = myH;
+        g1Phase = myG1Phase;
+        out = myOut; stride = myStride;
+    }
+
+    void run()
+    {
+        renderer->renderTile(x, y, w, h, g1Phase, out, stride);
+    }
+
+private:
+    const OfflineRenderer* renderer;
+    int x, y, w, h;
+    bool g1Phase;
+    float* out;
+    int stride;
+};
+
+/**
+Constructor:
+  Takes the preset's colors and boxes at the output size
+*/
+OfflineRenderer::OfflineRenderer(const FlickerSetting& setting, QSize mySize)
+{
+    size = mySize;
+    tileSize = DEFAULT_TILE_SIZE;
+
+    int colorVals[12];
+    for(int i=0; i<12; i++)
+        colorVals[i] = setting.colorVals[i];
+    painter.setColors(colorVals);
+    painter.setSize(size);
+    painter.setBoxNum(setting.numBoxes);
+}
+
+void OfflineRenderer::setTileSize(int tile)
+{
+    tileSize = tile < 16 ? 16 : tile;
+}
+
+/**
+Render tile:
+  The same picture FlickerPainter::paint() draws, in float.
+  Later boxes cover earlier ones where rounding makes them overlap,
+  and colors run top to bottom as GL interpolates them at pixel centers.
+*/
+void OfflineRenderer::renderTile(int x, int y, int w, int h, bool g1Phase,
+                                 float* out, int stride) const
+{
+    int numBoxes = painter.boxNum();
+    int width = size.width(), height = size.height();
+
+    // Last column drawn over each pixel column
+    QVector<int> cols(w);
+    for(int i=0; i<w; i++) {
+        int px = x + i;
+        int col = qMin(numBoxes-1, (int)((qint64)px * numBoxes / width));
+        while(col+1 < numBoxes && painter.boxRect(col+1, 0).x() <= px) ++col;
+        while(col > 0 && painter.boxRect(col, 0).x() > px) --col;
+        cols[i] = col;
+    }
+
+    for(int j=0; j<h; j++) {
+        int py = y + j;
+        int row = qMin(numBoxes-1, (int)((qint64)py * numBoxes / height));
+        while(row+1 < numBoxes && painter.boxRect(0, row+1).y() <= py) ++row;
+        while(row > 0 && painter.boxRect(0, row).y() > py) --row;
+
+        QRect rowBox = painter.boxRect(0, row);
+        float t = (py + 0.5f - rowBox.y()) / rowBox.height();
+
+        float* dst = out + j*stride*3;
+        int lastCol = -1;
+        float color[3];
+        for(int i=0; i<w; i++) {
+            if(cols[i] != lastCol) {
+                lastCol = cols[i];
+                float top[3]; float bottom[3];
+                painter.boxColors(lastCol, row, g1Phase, top, bottom);
+                for(int c=0; c<3; c++)
+                    color[c] = top[c] + (bottom[c] - top[c]) * t;
+            }
+            dst[i*3+0] = color[0];
+            dst[i*3+1] = color[1];
+            dst[i*3+2] = color[2];
+        }
+    }
+}
+
+/**
+Render:
+  Shades band n+1 on the pool while band n is being written
+*/
+bool OfflineRenderer::render(const QString& fileName, bool g1Phase)
+{
+    StillWriter* writer = StillWriter::forFile(fileName);
+    if(!writer) {
+        qDebug("Unknown image type; use .png, .tif or .raw");
+        return false;
+    }
+
+    int width = size.width(), height = size.height();
+    if(width < 1 || height < 1 || !writer->begin(fileName, width, height)) {
+        delete writer;
+        return false;
+    }
+
+    QThreadPool pool;
+    QVector<float> bands[2];
+    bands[0].resize(width * tileSize * 3);
+    bands[1].resize(width * tileSize * 3);
+
+    bool isOk = true;
+    int pending = -1; // Band waiting to be written
+    for(int band=0, y=0; y < height || pending >= 0; ++band, y += tileSize) {
+        int rows = qMin(tileSize, height - y);
+        float* out = bands[band % 2].data();
+
+        if(y < height) {
+            for(int x=0; x < width; x += tileSize)
+                pool.start(new TileJob(this, x, y, qMin(tileSize, width - x), rows,
+                                       g1Phase, out + x*3, width));
+        }
+
+        if(pending >= 0 && isOk) {
+            int pendingRows = qMin(tileSize, height - pending*tileSize);
+            isOk = writer->writeRows(bands[pending % 2].constData(), pendingRows);
+        }
+
+        pool.waitForDone();
+        pending = y < height ? band : -1;
+    }
+
+    isOk = writer->finish() && isOk;
+    delete writer;
+    return isOk;
+}
+
+/**
+Render both:
+  One file per phase, name-1.ext for gradient 1 and name-2.ext for gradient 2
+*/
+bool OfflineRenderer::renderBoth(const QString& fileName)
+{
+    QFileInfo info(fileName);
+    QString base = info.path() + "/" + info.completeBaseName();
+    QString ext = info.suffix();
+
+    return render(base + "-1." + ext, true)
+        && render(base + "-2." + ext, false);
+}
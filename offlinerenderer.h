@@ -0,0 +1,51 @@
+//This file is part of The Garden Path
+
+//The Garden Path is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//The Garden Path is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with The Garden Path.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef OFFLINERENDERER_H
+#define OFFLINERENDERER_H
+
+#include <QSize>
+#include <QString>
+
+#include "flickersetting.h"
+#include "flickerpainter.h"
+
+// Renders single frames of a preset at any size without a window.
+// The image is cut into a band of tiles at a time; tiles are shaded
+// in float on a thread pool while the band before is written out.
+// Memory is two float bands plus one encoded row, however tall the
+// image is.
+class OfflineRenderer
+{
+public:
+    OfflineRenderer(const FlickerSetting&, QSize size);
+    void setTileSize(int);
+
+    // Render one phase to a .png, .tif or .raw file
+    bool render(const QString& fileName, bool g1Phase);
+    // Render both phases, as name-1.ext (gradient 1) and name-2.ext
+    bool renderBoth(const QString& fileName);
+
+    // Shade pixels [x, x+w) x [y, y+h) into out, stride pixels per row
+    void renderTile(int x, int y, int w, int h, bool g1Phase,
+                    float* out, int stride) const;
+
+private:
+    FlickerPainter painter;
+    QSize size;
+    int tileSize;
+};
+
+#endif // OFFLINERENDERER_H
@@ -0,0 +1,282 @@
+//This file is part of The Garden Path
+
+//The Garden Path is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//The Garden Path is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with The Garden Path.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <cstring>
+#include <algorithm>
+#include <QDir>
+#include <QFileInfo>
+#include <QVector>
+
+#include "presetbundle.h"
+
+/**
+Constructor:
+  Starts closed
+*/
+PresetBundle::PresetBundle()
+{
+    data = 0;
+    header = 0;
+    records = 0;
+    index = 0;
+    names = 0;
+}
+
+PresetBundle::~PresetBundle()
+{
+    close();
+}
+
+/**
+Open:
+  Maps the file and checks every offset lies inside it
+  and every index entry names a record
+*/
+bool PresetBundle::open(const QString& fileName)
+{
+    close();
+
+    file.setFileName(fileName);
+    if(!file.open(QIODevice::ReadOnly))
+        return false;
+
+    qint64 size = file.size();
+    if(size < (qint64)sizeof(BundleHeader)) {
+        close();
+        return false;
+    }
+
+    data = file.map(0, size);
+    if(!data) {
+        qDebug("Unexpected error mapping preset bundle!");
+        close();
+        return false;
+    }
+
+    const BundleHeader* h = (const BundleHeader*)data;
+    bool isValid = memcmp(h->magic, BUNDLE_MAGIC, 8) == 0
+            && h->version == BUNDLE_VERSION
+            && (qint64)h->recordOffset + (qint64)h->count * (qint64)sizeof(BundleRecord) <= size
+            && (qint64)h->indexOffset + (qint64)h->count * (qint64)sizeof(quint32) <= size
+            && (qint64)h->nameOffset + (qint64)h->nameSize <= size
+            && (h->nameSize == 0 || data[h->nameOffset + h->nameSize - 1] == '\0');
+    const quint32* idx = (const quint32*)(data + h->indexOffset);
+    for(quint32 i=0; isValid && i < h->count; i++)
+        isValid = idx[i] < h->count;
+    if(!isValid) {
+        qDebug("Not a valid preset bundle.");
+        close();
+        return false;
+    }
+
+    header = h;
+    records = (const BundleRecord*)(data + h->recordOffset);
+    index = idx;
+    names = (const char*)(data + h->nameOffset);
+    return true;
+}
+
+/**
+Close:
+  Unmaps the file; names handed out are no longer valid
+*/
+void PresetBundle::close()
+{
+    if(data) file.unmap(data);
+    file.close();
+
+    data = 0;
+    header = 0;
+    records = 0;
+    index = 0;
+    names = 0;
+}
+
+int PresetBundle::count() const
+{
+    return header ? header->count : 0;
+}
+
+const char* PresetBundle::name(int i) const
+{
+    quint32 offset = records[i].name;
+    return offset < header->nameSize ? names + offset : "";
+}
+
+FlickerSetting PresetBundle::setting(int i) const
+{
+    const BundleRecord& rec = records[i];
+
+    int colorVals[12];
+    for(int c=0; c<12; c++)
+        colorVals[c] = rec.colorVals[c];
+
+    return FlickerSetting(name(i), colorVals, rec.speed,
+                          rec.isMaxSpeed != 0, rec.numBoxes);
+}
+
+int PresetBundle::indexOf(const char* target) const
+{
+    int lo = 0, hi = count() - 1;
+    while(lo <= hi) {
+        int mid = (lo + hi) / 2;
+        quint32 rec = index[mid];
+        int cmp = strcmp(name(rec), target);
+        if(cmp == 0) return rec;
+        else if(cmp < 0) lo = mid + 1;
+        else hi = mid - 1;
+    }
+    return -1;
+}
+
+// Orders record numbers by the names they point at
+struct NameLess
+{
+    const QList<QByteArray>* names;
+    bool operator()(quint32 a, quint32 b) const
+    {
+        return strcmp(names->at(a).constData(), names->at(b).constData()) < 0;
+    }
+};
+
+/**
+Write:
+  Lays out header, records, index and names in one pass
+*/
+bool PresetBundle::write(const QString& fileName, const QStringList& names,
+                         const QList<FlickerSetting>& settings)
+{
+    if(names.size() != settings.size()) return false;
+    quint32 count = settings.size();
+
+    QList<QByteArray> asciiNames;
+    QByteArray nameBlock;
+    QVector<BundleRecord> recs(count);
+    for(quint32 i=0; i<count; i++) {
+        const FlickerSetting& s = settings.at(i);
+        BundleRecord& rec = recs[i];
+        memset(&rec, 0, sizeof(rec));
+
+        for(int c=0; c<12; c++)
+            rec.colorVals[c] = qBound(0, s.colorVals[c], 255);
+        rec.speed = qBound(0, s.speed, 0xFFFF);
+        rec.numBoxes = qBound(1, s.numBoxes, 0xFFFF);
+        rec.isMaxSpeed = s.isMaxSpeed ? 1 : 0;
+        rec.name = nameBlock.size();
+
+        asciiNames << names.at(i).toAscii();
+        nameBlock.append(asciiNames.last());
+        nameBlock.append('\0');
+    }
+
+    QVector<quint32> sorted(count);
+    for(quint32 i=0; i<count; i++)
+        sorted[i] = i;
+    NameLess less = { &asciiNames };
+    std::sort(sorted.begin(), sorted.end(), less);
+
+    BundleHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BUNDLE_MAGIC, 8);
+    header.version = BUNDLE_VERSION;
+    header.count = count;
+    header.recordOffset = sizeof(BundleHeader);
+    header.indexOffset = header.recordOffset + count * sizeof(BundleRecord);
+    header.nameOffset = header.indexOffset + count * sizeof(quint32);
+    header.nameSize = nameBlock.size();
+
+    QFile fp(fileName);
+    if(!fp.open(QIODevice::WriteOnly)) {
+        qDebug("Unexpected error saving preset bundle");
+        return false;
+    }
+    fp.write((const char*)&header, sizeof(header));
+    fp.write((const char*)recs.constData(), count * sizeof(BundleRecord));
+    fp.write((const char*)sorted.constData(), count * sizeof(quint32));
+    fp.write(nameBlock);
+    fp.close();
+
+    return fp.error() == QFile::NoError;
+}
+
+/**
+From XML:
+  Compiles every FlickerOptions file in a directory
+*/
+bool PresetBundle::fromXml(const QString& dirName, const QString& fileName)
+{
+    QStringList fileTypes;
+    fileTypes << "*.xml";
+    QFileInfoList fileList = QDir(dirName).entryInfoList(fileTypes);
+
+    QStringList names;
+    QList<FlickerSetting> settings;
+    for(int i=0; i<fileList.size(); ++i) {
+        QFile fp(fileList.at(i).absoluteFilePath());
+        if(!fp.open(QIODevice::ReadOnly)) {
+            qDebug("Unexpected error opening preset!");
+            return false;
+        }
+
+        // Initialize with default vals
+        int colors[12] = {0};
+        int speed = 60;
+        bool isMaxSpeed = false;
+        int numBoxes = 1;
+
+        if(FlickerSetting::readXml(&fp, colors, speed, isMaxSpeed, numBoxes)) {
+            names << fileList.at(i).baseName();
+            settings << FlickerSetting("", colors, speed, isMaxSpeed, numBoxes);
+        }
+        fp.close();
+    }
+
+    return write(fileName, names, settings);
+}
+
+/**
+To XML:
+  Writes one FlickerOptions file per preset in a bundle
+*/
+bool PresetBundle::toXml(const QString& fileName, const QString& dirName)
+{
+    PresetBundle bundle;
+    if(!bundle.open(fileName)) return false;
+
+    QDir dir(dirName);
+    if(!dir.exists() && !dir.mkpath(".")) return false;
+
+    for(int i=0; i<bundle.count(); ++i) {
+        FlickerSetting s = bundle.setting(i);
+
+        // Names come from the file; never let one leave dirName
+        QString name(s.name);
+        if(name.isEmpty() || name.contains('/') || name.contains('\\')
+                || name.contains("..")) {
+            qDebug("Preset bundle holds an unsafe name; not extracting it.");
+            return false;
+        }
+
+        QFile fp(dir.filePath(name + ".xml"));
+        if(!fp.open(QIODevice::WriteOnly)) {
+            qDebug("Unexpected error saving preset");
+            return false;
+        }
+        FlickerSetting::writeXml(&fp, s.colorVals, s.speed,
+                                 s.isMaxSpeed, s.numBoxes);
+        fp.close();
+    }
+    return true;
+}
@@ -0,0 +1,98 @@
+//This file is part of The Garden Path
+
+//The Garden Path is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//The Garden Path is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with The Garden Path.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef PRESETBUNDLE_H
+#define PRESETBUNDLE_H
+
+#include <QtGlobal>
+#include <QFile>
+#include <QList>
+#include <QStringList>
+
+#include "flickersetting.h"
+
+/*******************************************************************
+    A compiled library of presets (*.gpb), read by memory mapping
+    the file, so opening it parses nothing however many presets it
+    holds and concurrent instances share the pages.
+
+    Layout, in host byte order:
+        BundleHeader
+        BundleRecord[count]    in the order presets were added
+        quint32[count]         record numbers sorted by name
+        names                  nul-terminated, packed
+ *******************************************************************/
+
+#define BUNDLE_MAGIC "GPBUNDLE"
+#define BUNDLE_VERSION 1
+
+struct BundleHeader
+{
+    char magic[8];          // BUNDLE_MAGIC, no terminator
+    quint32 version;        // BUNDLE_VERSION
+    quint32 count;          // Number of presets
+    quint32 recordOffset;   // Offsets from start of file
+    quint32 indexOffset;
+    quint32 nameOffset;
+    quint32 nameSize;
+};
+
+struct BundleRecord
+{
+    quint8 colorVals[12];
+    quint16 speed;          // Hz
+    quint16 numBoxes;
+    quint8 isMaxSpeed;
+    quint8 reserved[3];
+    quint32 name;           // Offset into names
+};
+
+class PresetBundle
+{
+public:
+    PresetBundle();
+    ~PresetBundle();
+
+    // Map a bundle. False if it is missing or not a valid bundle.
+    bool open(const QString& fileName);
+    void close();
+    bool isOpen() const { return header != 0; }
+
+    int count() const;
+    // Points into the mapping; valid until close()
+    const char* name(int i) const;
+    FlickerSetting setting(int i) const;
+    // Binary search by name; -1 if not found
+    int indexOf(const char* name) const;
+
+    // Compile presets into a bundle. Names are taken from names,
+    // not from the settings.
+    static bool write(const QString& fileName, const QStringList& names,
+                      const QList<FlickerSetting>& settings);
+
+    // Convert a directory of FlickerOptions xml files to a bundle and back
+    static bool fromXml(const QString& dirName, const QString& fileName);
+    static bool toXml(const QString& fileName, const QString& dirName);
+
+private:
+    QFile file;
+    uchar* data;
+    const BundleHeader* header;
+    const BundleRecord* records;
+    const quint32* index;
+    const char* names;
+};
+
+#endif // PRESETBUNDLE_H
@@ -0,0 +1,71 @@
+//This file is part of The Garden Path
+
+//The Garden Path is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//The Garden Path is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with The Garden Path.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "presetlistmodel.h"
+
+PresetListModel::PresetListModel(const QStringList* myXmlNames,
+                                 const QList<PresetBundle*>* myBundles,
+                                 QObject* parent)
+    : QAbstractListModel(parent)
+{
+    xmlNames = myXmlNames;
+    bundles = myBundles;
+}
+
+int PresetListModel::rowCount(const QModelIndex& parent) const
+{
+    if(parent.isValid()) return 0;
+
+    int rows = xmlNames->size();
+    for(int i=0; i<bundles->size(); ++i)
+        rows += bundles->at(i)->count();
+    return rows;
+}
+
+PresetBundle* PresetListModel::bundleAt(int row, int* bundleRow) const
+{
+    row -= xmlNames->size();
+    if(row < 0) return 0;
+
+    for(int i=0; i<bundles->size(); ++i) {
+        PresetBundle* bundle = bundles->at(i);
+        if(row < bundle->count()) {
+            *bundleRow = row;
+            return bundle;
+        }
+        row -= bundle->count();
+    }
+    return 0;
+}
+
+QVariant PresetListModel::data(const QModelIndex& index, int role) const
+{
+    if(!index.isValid() || role != Qt::DisplayRole)
+        return QVariant();
+
+    int row = index.row();
+    if(row < xmlNames->size())
+        return xmlNames->at(row);
+
+    int bundleRow;
+    PresetBundle* bundle = bundleAt(row, &bundleRow);
+    return bundle ? QString(bundle->name(bundleRow)) : QVariant();
+}
+
+void PresetListModel::refresh()
+{
+    beginResetModel();
+    endResetModel();
+}
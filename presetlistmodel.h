@@ -0,0 +1,51 @@
+//This file is part of The Garden Path
+
+//The Garden Path is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//The Garden Path is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with The Garden Path.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef PRESETLISTMODEL_H
+#define PRESETLISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QStringList>
+#include <QList>
+
+#include "presetbundle.h"
+
+// The preset list: XML presets first, then every bundle's presets.
+// Bundle rows are read from the mapping only when the view asks,
+// so a large bundle costs nothing to list.
+class PresetListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    PresetListModel(const QStringList* xmlNames,
+                    const QList<PresetBundle*>* bundles,
+                    QObject* parent = 0);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const;
+    QVariant data(const QModelIndex& index, int role) const;
+
+    // Which bundle holds row, and where; NULL for XML rows
+    PresetBundle* bundleAt(int row, int* bundleRow) const;
+
+    // Call after the lists it reads from change
+    void refresh();
+
+private:
+    const QStringList* xmlNames;
+    const QList<PresetBundle*>* bundles;
+};
+
+#endif // PRESETLISTMODEL_H
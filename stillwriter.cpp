@@ -0,0 +1,351 @@
+//This file is part of The Garden Path
+
+//The Garden Path is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//The Garden Path is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with The Garden Path.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stillwriter.h"
+
+static void putBE16(QByteArray& out, quint16 v)
+{
+    out.append((char)(v >> 8));
+    out.append((char)(v & 0xFF));
+}
+
+static void putBE32(QByteArray& out, quint32 v)
+{
+    putBE16(out, v >> 16);
+    putBE16(out, v & 0xFFFF);
+}
+
+static void putLE16(QByteArray& out, quint16 v)
+{
+    out.append((char)(v & 0xFF));
+    out.append((char)(v >> 8));
+}
+
+static void putLE32(QByteArray& out, quint32 v)
+{
+    putLE16(out, v & 0xFFFF);
+    putLE16(out, v >> 16);
+}
+
+// [0, 1] to the full 16-bit range, rounded
+static quint16 toSample(float v)
+{
+    return qBound(0, (int)(v * 65535.0f + 0.5f), 65535);
+}
+
+StillWriter* StillWriter::forFile(const QString& fileName)
+{
+    QString lower = fileName.toLower();
+    if(lower.endsWith(".png")) return new PngWriter();
+    if(lower.endsWith(".tif") || lower.endsWith(".tiff")) return new TiffWriter();
+    if(lower.endsWith(".raw")) return new RawWriter();
+    return 0;
+}
+
+
+/*******************************************************************
+    PNG
+ *******************************************************************/
+
+static quint32 crcTable[256];
+
+// Running CRC-32; start from 0xFFFFFFFF and invert at the end
+static quint32 updateCrc(quint32 c, const uchar* p, quint32 len)
+{
+    if(crcTable[1] == 0) {
+        for(quint32 n=0; n<256; n++) {
+            quint32 t = n;
+            for(int k=0; k<8; k++)
+                t = (t & 1) ? 0xEDB88320u ^ (t >> 1) : t >> 1;
+            crcTable[n] = t;
+        }
+    }
+
+    while(len--)
+        c = crcTable[(c ^ *p++) & 0xFF] ^ (c >> 8);
+    return c;
+}
+
+// Running Adler-32. 5552 bytes is the longest run whose sums cannot
+// overflow 32 bits, so the modulo is only taken once per run.
+static quint32 updateAdler(quint32 adler, const uchar* p, quint32 len)
+{
+    quint32 a = adler & 0xFFFF, b = adler >> 16;
+    while(len > 0) {
+        quint32 n = qMin(len, (quint32)5552);
+        len -= n;
+        while(n--) {
+            a += *p++;
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+    }
+    return (b << 16) | a;
+}
+
+/**
+Chunks:
+  The length goes first, so it must be known before the data;
+  the data can then be written in pieces as the CRC runs over it
+*/
+void PngWriter::beginChunk(const char* type, quint32 length)
+{
+    QByteArray head;
+    putBE32(head, length);
+    head.append(type, 4);
+    file.write(head);
+
+    crc = updateCrc(0xFFFFFFFFu, (const uchar*)type, 4);
+}
+
+void PngWriter::chunkData(const char* data, quint32 length)
+{
+    file.write(data, length);
+    crc = updateCrc(crc, (const uchar*)data, length);
+}
+
+void PngWriter::endChunk()
+{
+    QByteArray tail;
+    putBE32(tail, crc ^ 0xFFFFFFFFu);
+    file.write(tail);
+}
+
+void PngWriter::writeChunk(const char* type, const QByteArray& data)
+{
+    beginChunk(type, data.size());
+    chunkData(data.constData(), data.size());
+    endChunk();
+}
+
+bool PngWriter::begin(const QString& fileName, int width, int height)
+{
+    w = width; h = height;
+    adler = 1;
+
+    file.setFileName(fileName);
+    if(!file.open(QIODevice::WriteOnly)) return false;
+
+    file.write("\x89PNG\r\n\x1a\n", 8);
+
+    QByteArray ihdr;
+    putBE32(ihdr, w);
+    putBE32(ihdr, h);
+    ihdr.append((char)16); // Bit depth
+    ihdr.append((char)2);  // Truecolor
+    ihdr.append((char)0);  // Deflate
+    ihdr.append((char)0);  // Adaptive filtering
+    ihdr.append((char)0);  // No interlace
+    writeChunk("IHDR", ihdr);
+
+    // zlib header: deflate, 32K window, no preset dictionary
+    writeChunk("IDAT", QByteArray("\x78\x01", 2));
+    return true;
+}
+
+bool PngWriter::writeRows(const float* rgb, int rows)
+{
+    // Stored (uncompressed) deflate blocks hold at most 64K each.
+    // Their sizes are known up front, so the band is one IDAT written
+    // a row at a time, never held encoded as a whole.
+    quint32 rowSize = 1 + w*6;
+    quint32 left = rows * rowSize;
+    quint32 blocks = (left + 0xFFFE) / 0xFFFF;
+    beginChunk("IDAT", left + blocks*5);
+
+    QByteArray row(rowSize, 0); // Filter type 0 stays in front
+    quint32 blockLeft = 0;
+    for(int y=0; y<rows; y++) {
+        uchar* out = (uchar*)row.data() + 1;
+        const float* in = rgb + (qint64)y*w*3;
+        for(int i=0; i<w*3; i++) {
+            quint16 v = toSample(in[i]);
+            *out++ = v >> 8;
+            *out++ = v & 0xFF;
+        }
+        adler = updateAdler(adler, (const uchar*)row.constData(), rowSize);
+
+        for(quint32 pos=0; pos < rowSize; ) {
+            if(blockLeft == 0) {
+                blockLeft = qMin((quint32)0xFFFF, left);
+                QByteArray head;
+                head.append((char)0); // Not the final block
+                putLE16(head, blockLeft);
+                putLE16(head, ~blockLeft & 0xFFFF);
+                chunkData(head.constData(), head.size());
+            }
+            quint32 len = qMin(blockLeft, rowSize - pos);
+            chunkData(row.constData() + pos, len);
+            pos += len;
+            blockLeft -= len;
+            left -= len;
+        }
+    }
+    endChunk();
+
+    return file.error() == QFile::NoError;
+}
+
+bool PngWriter::finish()
+{
+    // Empty final block, then the checksum of everything before it
+    QByteArray idat;
+    idat.append((char)1);
+    putLE16(idat, 0);
+    putLE16(idat, 0xFFFF);
+    putBE32(idat, adler);
+    writeChunk("IDAT", idat);
+
+    writeChunk("IEND", QByteArray());
+    file.close();
+    return file.error() == QFile::NoError;
+}
+
+
+/*******************************************************************
+    TIFF
+ *******************************************************************/
+
+bool TiffWriter::begin(const QString& fileName, int width, int height)
+{
+    w = width; h = height;
+    stripOffsets.clear();
+    stripRows.clear();
+
+    // Classic TIFF offsets are 32 bits; leave room for the IFD too
+    if((qint64)w * h * 6 + 65536 > (qint64)0xFFFFFFFFu) {
+        qDebug("Image too big for TIFF; use .png or .raw");
+        return false;
+    }
+
+    file.setFileName(fileName);
+    if(!file.open(QIODevice::WriteOnly)) return false;
+
+    // Little-endian; the first IFD offset is patched in by finish()
+    QByteArray header("II", 2);
+    putLE16(header, 42);
+    putLE32(header, 0);
+    file.write(header);
+    return true;
+}
+
+bool TiffWriter::writeRows(const float* rgb, int rows)
+{
+    stripOffsets.append(file.pos());
+    stripRows.append(rows);
+
+    // The strip is written a row at a time
+    QByteArray row(w*6, 0);
+    for(int y=0; y<rows; y++) {
+        uchar* out = (uchar*)row.data();
+        const float* in = rgb + (qint64)y*w*3;
+        for(int i=0; i<w*3; i++) {
+            quint16 v = toSample(in[i]);
+            *out++ = v & 0xFF;
+            *out++ = v >> 8;
+        }
+        file.write(row);
+    }
+
+    return file.error() == QFile::NoError;
+}
+
+// One 12-byte IFD entry; SHORT values sit in the low half of value
+static void putEntry(QByteArray& out, quint16 tag, quint16 type,
+                     quint32 count, quint32 value)
+{
+    putLE16(out, tag);
+    putLE16(out, type);
+    putLE32(out, count);
+    if(type == 3 && count == 1) {
+        putLE16(out, value);
+        putLE16(out, 0);
+    } else {
+        putLE32(out, value);
+    }
+}
+
+bool TiffWriter::finish()
+{
+    const quint16 SHORT = 3, LONG = 4;
+    const int numEntries = 10;
+    quint32 strips = stripOffsets.size();
+
+    if(file.pos() % 2) file.write("", 1); // IFDs start on a word boundary
+    quint32 ifdOffset = file.pos();
+
+    // Values too big for an entry follow the IFD
+    quint32 extra = ifdOffset + 2 + numEntries*12 + 4;
+    quint32 bitsOffset = extra;
+    quint32 offsetsOffset = bitsOffset + 6;
+    quint32 countsOffset = offsetsOffset + strips*4;
+
+    QByteArray ifd;
+    putLE16(ifd, numEntries);
+    putEntry(ifd, 256, LONG, 1, w);                 // ImageWidth
+    putEntry(ifd, 257, LONG, 1, h);                 // ImageLength
+    putEntry(ifd, 258, SHORT, 3, bitsOffset);       // BitsPerSample
+    putEntry(ifd, 259, SHORT, 1, 1);                // No compression
+    putEntry(ifd, 262, SHORT, 1, 2);                // RGB
+    putEntry(ifd, 273, LONG, strips,                // StripOffsets
+             strips == 1 ? stripOffsets.at(0) : offsetsOffset);
+    putEntry(ifd, 277, SHORT, 1, 3);                // SamplesPerPixel
+    putEntry(ifd, 278, LONG, 1, strips ? stripRows.at(0) : h); // RowsPerStrip
+    putEntry(ifd, 279, LONG, strips,                // StripByteCounts
+             strips == 1 ? stripRows.at(0)*w*6 : countsOffset);
+    putEntry(ifd, 284, SHORT, 1, 1);                // Interleaved
+    putLE32(ifd, 0); // No more IFDs
+
+    for(int i=0; i<3; i++)
+        putLE16(ifd, 16);
+    for(quint32 i=0; i<strips; i++)
+        putLE32(ifd, stripOffsets.at(i));
+    for(quint32 i=0; i<strips; i++)
+        putLE32(ifd, stripRows.at(i)*w*6);
+    file.write(ifd);
+
+    QByteArray patch;
+    putLE32(patch, ifdOffset);
+    file.seek(4);
+    file.write(patch);
+
+    file.close();
+    return file.error() == QFile::NoError;
+}
+
+
+/*******************************************************************
+    Raw
+ *******************************************************************/
+
+bool RawWriter::begin(const QString& fileName, int width, int height)
+{
+    w = width; h = height;
+    file.setFileName(fileName);
+    return file.open(QIODevice::WriteOnly);
+}
+
+bool RawWriter::writeRows(const float* rgb, int rows)
+{
+    file.write((const char*)rgb, (qint64)rows * w*3 * sizeof(float));
+    return file.error() == QFile::NoError;
+}
+
+bool RawWriter::finish()
+{
+    file.close();
+    return file.error() == QFile::NoError;
+}
@@ -0,0 +1,82 @@
+//This file is part of The Garden Path
+
+//The Garden Path is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//The Garden Path is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with The Garden Path.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef STILLWRITER_H
+#define STILLWRITER_H
+
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+// Writes an image top to bottom, a band of rows at a time, so the
+// whole picture never has to be held in memory.
+// Pixels come in as r, g, b floats in [0, 1].
+class StillWriter
+{
+public:
+    virtual ~StillWriter() {}
+    virtual bool begin(const QString& fileName, int width, int height) = 0;
+    virtual bool writeRows(const float* rgb, int rows) = 0;
+    virtual bool finish() = 0;
+
+    // Picks a writer from the extension: .png, .tif/.tiff or .raw
+    static StillWriter* forFile(const QString& fileName);
+
+protected:
+    QFile file;
+    int w, h;
+};
+
+// 16 bits per channel RGB, zlib stored blocks so only a row is buffered
+class PngWriter : public StillWriter
+{
+public:
+    bool begin(const QString& fileName, int width, int height);
+    bool writeRows(const float* rgb, int rows);
+    bool finish();
+
+private:
+    void beginChunk(const char* type, quint32 length);
+    void chunkData(const char* data, quint32 length);
+    void endChunk();
+    void writeChunk(const char* type, const QByteArray& data);
+    quint32 adler; // Over all image data so far
+    quint32 crc;   // Over the chunk being written
+};
+
+// 16 bits per channel RGB, uncompressed, one strip per band.
+// Classic TIFF only, so begin() refuses images over 4GB.
+class TiffWriter : public StillWriter
+{
+public:
+    bool begin(const QString& fileName, int width, int height);
+    bool writeRows(const float* rgb, int rows);
+    bool finish();
+
+private:
+    QVector<quint32> stripOffsets;
+    QVector<quint32> stripRows;
+};
+
+// Bare 32-bit float RGB, row after row, no header
+class RawWriter : public StillWriter
+{
+public:
+    bool begin(const QString& fileName, int width, int height);
+    bool writeRows(const float* rgb, int rows);
+    bool finish();
+};
+
+#endif // STILLWRITER_H